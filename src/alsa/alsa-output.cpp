@@ -1,10 +1,25 @@
+#include <json.hpp>
+#include <jsontest.hpp>
+
 #include "alsa-output.hpp"
 #include "config.h"
+#include "format-negotiation.hpp"
 #include "playback.hpp"
 #include "type.hpp"
 #include <alsa/error.h>
 #include <alsa/pcm.h>
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <functional>
 #include <mutex>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <thread>
+#include <unistd.h>
 
 #define TEST_ERROR(message)       \
     if(error < 0) {               \
@@ -12,73 +27,268 @@
         break;                    \
     }
 
-void WriteQueue::proc(std::vector<AsyncCallbackCommands> queue) {
-    for(auto c : queue) {
-        switch(c) {
-        case AsyncCallbackCommands::Write:
-            owner.write_pcm_data();
-            break;
-        }
-    }
+namespace {
+const struct {
+    boxten::SampleType boxten_format;
+    snd_pcm_format_t   alsa_format;
+} format_table[] =
+    {
+        {boxten::SampleType::f32_le, SND_PCM_FORMAT_FLOAT},
+        // {boxten::SampleType::f32_be, SND_PCM_FORMAT_FLOAT},
+        {boxten::SampleType::s8, SND_PCM_FORMAT_S8},
+        {boxten::SampleType::u8, SND_PCM_FORMAT_U8},
+        {boxten::SampleType::s16_le, SND_PCM_FORMAT_S16_LE},
+        {boxten::SampleType::s16_be, SND_PCM_FORMAT_S16_BE},
+        {boxten::SampleType::u16_le, SND_PCM_FORMAT_U16_LE},
+        {boxten::SampleType::u16_be, SND_PCM_FORMAT_U16_BE},
+        {boxten::SampleType::s24_le, SND_PCM_FORMAT_S24_3LE},
+        {boxten::SampleType::s24_be, SND_PCM_FORMAT_S24_3BE},
+        {boxten::SampleType::u24_le, SND_PCM_FORMAT_U24_3LE},
+        {boxten::SampleType::u24_be, SND_PCM_FORMAT_U24_3BE},
+        {boxten::SampleType::s32_le, SND_PCM_FORMAT_S32_LE},
+        {boxten::SampleType::s32_be, SND_PCM_FORMAT_S32_BE},
+        {boxten::SampleType::u32_le, SND_PCM_FORMAT_U32_LE},
+        {boxten::SampleType::u32_be, SND_PCM_FORMAT_U32_BE},
+};
+
+u64 nanoseconds_between(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+u64 nanoseconds_since_epoch(std::chrono::steady_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
 }
 
-namespace {
-void async_callback(snd_async_handler_t* async_handle) {
-    auto alsa_output = reinterpret_cast<AlsaOutput*>(snd_async_handler_get_callback_private(async_handle));
-    alsa_output->add_queue();
+u64 count_frames(const std::vector<boxten::PCMPacketUnit>& packets) {
+    u64 frames = 0;
+    for(const auto& packet : packets) {
+        frames += packet.get_frames();
+    }
+    return frames;
 }
+
+// packets the feeder may queue ahead of the writer
+constexpr size_t ring_slots = 64;
+
+// channel counts worth asking the device for
+constexpr u32 max_channels = 8;
+
+// rates worth asking the device for
+constexpr unsigned int candidate_rates[] = {8000, 11025, 16000, 22050, 32000, 44100, 48000, 88200, 96000, 176400, 192000, 352800, 384000};
+
 } // namespace
 
 snd_pcm_format_t AlsaOutput::convert_alsa_format() {
-    static const struct {
-        boxten::SampleType boxten_format;
-        snd_pcm_format_t   alsa_format;
-    } table[] =
-        {
-            {boxten::SampleType::f32_le, SND_PCM_FORMAT_FLOAT},
-            // {boxten::SampleType::f32_be, SND_PCM_FORMAT_FLOAT},
-            {boxten::SampleType::s8, SND_PCM_FORMAT_S8},
-            {boxten::SampleType::u8, SND_PCM_FORMAT_U8},
-            {boxten::SampleType::s16_le, SND_PCM_FORMAT_S16_LE},
-            {boxten::SampleType::s16_be, SND_PCM_FORMAT_S16_BE},
-            {boxten::SampleType::u16_le, SND_PCM_FORMAT_U16_LE},
-            {boxten::SampleType::u16_be, SND_PCM_FORMAT_U16_BE},
-            {boxten::SampleType::s24_le, SND_PCM_FORMAT_S24_LE},
-            {boxten::SampleType::s24_be, SND_PCM_FORMAT_S24_BE},
-            {boxten::SampleType::u24_le, SND_PCM_FORMAT_U24_LE},
-            {boxten::SampleType::u24_be, SND_PCM_FORMAT_U24_BE},
-            {boxten::SampleType::s32_le, SND_PCM_FORMAT_S32_LE},
-            {boxten::SampleType::s32_be, SND_PCM_FORMAT_S32_BE},
-            {boxten::SampleType::u32_le, SND_PCM_FORMAT_U32_LE},
-            {boxten::SampleType::u32_be, SND_PCM_FORMAT_U32_BE},
-        };
-
-    for(auto& f : table) {
+    for(auto& f : format_table) {
         if(f.boxten_format == current_format.sample_type) {
             return f.alsa_format;
         }
     }
     return SND_PCM_FORMAT_UNKNOWN;
 }
-void AlsaOutput::add_queue() {
-    write_queue.enqueue(AsyncCallbackCommands::Write);
+void AlsaOutput::publish_device_formats() {
+    snd_pcm_t*           handle    = nullptr;
+    snd_pcm_hw_params_t* hw_params = nullptr;
+    if(auto error = snd_pcm_open(&handle, device_config.name.data(), SND_PCM_STREAM_PLAYBACK, SND_PCM_NONBLOCK); error < 0) {
+        console.error << "cannot open audio device \"" << device_config.name << "\" to probe formats (" << snd_strerror(error) << ").";
+        return;
+    }
+    negotiation::DeviceFormats formats;
+    if(snd_pcm_hw_params_malloc(&hw_params) == 0 && snd_pcm_hw_params_any(handle, hw_params) >= 0) {
+        for(auto& f : format_table) {
+            if(snd_pcm_hw_params_test_format(handle, hw_params, f.alsa_format) == 0) {
+                formats.sample_types.emplace_back(f.boxten_format);
+            }
+        }
+        for(auto rate : candidate_rates) {
+            if(snd_pcm_hw_params_test_rate(handle, hw_params, rate, 0) == 0) {
+                formats.sampling_rates.emplace_back(rate);
+            }
+        }
+        for(u32 channels = 1; channels <= max_channels; ++channels) {
+            if(snd_pcm_hw_params_test_channels(handle, hw_params, channels) == 0) {
+                formats.channel_counts.emplace_back(channels);
+            }
+        }
+    }
+    if(hw_params != nullptr) {
+        snd_pcm_hw_params_free(hw_params);
+    }
+    snd_pcm_close(handle);
+    if(formats.sample_types.empty()) {
+        console.error << "no usable sample format found on \"" << device_config.name << "\".";
+        return;
+    }
+    probed_formats = formats;
+    negotiation::publish(std::move(formats));
+}
+// copies up to frames frames of the queued packets to dst, stopping at a packet of another format.
+// the packets stay queued until release_frames().
+snd_pcm_uframes_t AlsaOutput::gather_frames(u8* dst, snd_pcm_uframes_t frames) {
+    const auto        frame_bytes = current_format.channels * current_format.get_sample_bytewidth();
+    snd_pcm_uframes_t copied      = 0;
+    u64               offset      = front_offset;
+    for(size_t i = 0; copied < frames; ++i, offset = 0) {
+        const auto packet = packets.peek(i);
+        if(packet == nullptr || packet->format != current_format) break;
+        // what follows a seek must not share a write with what precedes it
+        if(i != 0 && packets.is_marked(i)) break;
+        const auto n = std::min<snd_pcm_uframes_t>(frames - copied, packet->get_frames() - offset);
+        std::memcpy(dst + copied * frame_bytes, packet->pcm.data() + offset * frame_bytes, n * frame_bytes);
+        copied += n;
+    }
+    return copied;
 }
-bool AlsaOutput::write_packats(size_t frames) {
-    auto packet = get_buffer_pcm_packet(frames);
-    for(auto& p : packet) {
-        if(p.format != current_format) {
-            close_alsa_device();
-            current_format = p.format;
-            if(!init_alsa_device()) {
-                break;
+// drops frames the device took from the front of the queue, and the packets emptied by that
+void AlsaOutput::release_frames(snd_pcm_uframes_t frames) {
+    // the feeder refills by frames, not by slots, so it is told about partly played packets too
+    auto released = frames != 0;
+    frames_written += frames;
+    packets.consume(frames);
+    while(auto packet = packets.front()) {
+        const auto n = std::min<u64>(frames, packet->get_frames() - front_offset);
+        front_offset += n;
+        frames -= n;
+        if(front_offset != packet->get_frames()) break;
+        front_offset = 0;
+        packets.pop();
+        released = true;
+    }
+    if(released) {
+        eventfd_write(space_fd, 1);
+    }
+}
+// copies the queued frames straight into the dma area of the device, committing as much as it can at once.
+// returns the frames written, or a negative error code on failure.
+snd_pcm_sframes_t AlsaOutput::write_mmap(snd_pcm_uframes_t frames) {
+    snd_pcm_uframes_t written = 0;
+    while(written < frames) {
+        const snd_pcm_channel_area_t* areas;
+        snd_pcm_uframes_t             offset;
+        snd_pcm_uframes_t             chunk = frames - written;
+        if(auto error = snd_pcm_mmap_begin(playback_handle, &areas, &offset, &chunk); error < 0) {
+            return error;
+        }
+        if(chunk == 0) {
+            // the ring is full. the writer waits for the device in poll(), where wake_fd can interrupt it
+            break;
+        }
+        // interleaved access shares one area among every channel
+        auto       dst       = static_cast<u8*>(areas[0].addr) + (areas[0].first + offset * areas[0].step) / 8;
+        const auto copied    = gather_frames(dst, chunk);
+        if(copied == 0) {
+            // nothing queued in the open format, the area is left as it is
+            break;
+        }
+        const auto committed = snd_pcm_mmap_commit(playback_handle, offset, copied);
+        if(committed < 0) {
+            return committed;
+        }
+        if(static_cast<snd_pcm_uframes_t>(committed) != copied) {
+            return -EPIPE;
+        }
+        writer_stats.writes += 1;
+        release_frames(copied);
+        written += copied;
+        // the area only ends early at the end of the dma buffer, the queue at a format change or when it ran dry
+        if(copied < chunk) break;
+    }
+
+    // unlike snd_pcm_writei, committing never starts the stream
+    if(snd_pcm_state(playback_handle) == SND_PCM_STATE_PREPARED) {
+        const auto avail = snd_pcm_avail_update(playback_handle);
+        if(avail >= 0 && buffer_size - avail >= start_threshold) {
+            if(auto error = snd_pcm_start(playback_handle); error < 0) {
+                return error;
             }
         }
-        auto error = snd_pcm_writei(playback_handle, p.pcm.data(), p.get_frames());
-        if(error < 0) {
-            console.error << "write failed (" << snd_strerror(error) << ").";
-            return false;
+    }
+    return written;
+}
+// gathers the queued frames into one buffer so that they take a single snd_pcm_writei.
+// returns the frames written, or a negative error code on failure.
+snd_pcm_sframes_t AlsaOutput::write_staged(snd_pcm_uframes_t frames) {
+    const auto frame_bytes = current_format.channels * current_format.get_sample_bytewidth();
+    const auto copied      = gather_frames(staging.data(), std::min<snd_pcm_uframes_t>(frames, staging.size() / frame_bytes));
+    if(copied == 0) return 0;
+    const auto written = snd_pcm_writei(playback_handle, staging.data(), copied);
+    if(written < 0) {
+        return written;
+    }
+    writer_stats.writes += 1;
+    release_frames(written);
+    return written;
+}
+// the output is not told about seeks, but a packet that neither continues the previous
+// one nor starts a track can only come after one.
+bool AlsaOutput::follows_seek(const boxten::PCMPacketUnit& packet) {
+    const auto begin = packet.original_frame_pos[0];
+    // inputs disagree on whether the end position is inclusive, accept both
+    const auto seek = has_last_end && begin != 0 && (begin < last_end || begin > last_end + 1);
+    last_end        = packet.original_frame_pos[1];
+    has_last_end    = true;
+    return seek;
+}
+bool AlsaOutput::push_pending() {
+    bool pushed = false;
+    while(pending_next < pending.size()) {
+        auto slot = packets.back();
+        if(slot == nullptr) break;
+        const auto seek = follows_seek(pending[pending_next]);
+        // the buffer of the packet is freed here, not in the writer, which reads the copy in the slot
+        const auto frames = pending[pending_next].get_frames();
+        if(packets.fill(std::move(pending[pending_next++]))) {
+            lock_region(slot->pcm.data(), slot->pcm.capacity(), locked_payloads);
+        }
+        packets.push(seek);
+        // only after the ring counts them, so that output_delay() never misses them
+        pending_frames -= frames;
+        pushed = true;
+        if(seek) {
+            seek_nanoseconds = nanoseconds_since_epoch(std::chrono::steady_clock::now());
+            wake_writer();
+        }
+    }
+    return pushed;
+}
+// drops everything queued before the latest packet marked as following a seek, in the ring
+// and in the device, so that the new position is heard next.
+// returns false if there was no such packet.
+bool AlsaOutput::flush_to_seek() {
+    auto target = SIZE_MAX;
+    for(size_t i = 0; packets.peek(i) != nullptr; ++i) {
+        if(packets.is_marked(i) && packets.popped() + i != flushed_slot) {
+            target = i;
+        }
+    }
+    if(target == SIZE_MAX) return false;
+    flushed_slot = packets.popped() + target;
+    for(size_t i = 0; i < target; ++i) {
+        packets.consume(packets.front()->get_frames() - front_offset);
+        front_offset = 0;
+        packets.pop();
+    }
+    eventfd_write(space_fd, 1);
+    starved = false;
+
+    // rewinding keeps the device running, only what it is about to play stays.
+    // the frames taken back, or dropped, are never played, so they do not count as written.
+    const auto rewindable = snd_pcm_rewindable(playback_handle);
+    const auto rewound    = rewindable > 0 ? snd_pcm_rewind(playback_handle, rewindable) : rewindable;
+    if(rewound > 0) {
+        frames_written -= std::min<u64>(frames_written, rewound);
+    } else {
+        if(snd_pcm_sframes_t delay; snd_pcm_delay(playback_handle, &delay) == 0 && delay > 0) {
+            frames_written -= std::min<u64>(frames_written, delay);
+        }
+        snd_pcm_drop(playback_handle);
+        if(auto error = snd_pcm_prepare(playback_handle); error < 0) {
+            console.error << "cannot prepare audio interface after seek (" << snd_strerror(error) << ").";
         }
+        // a period is enough to start again, waiting for start_threshold would delay the new position
+        restart_early = true;
     }
+    seek_frames_written = frames_written;
+    seek_reported       = false;
     return true;
 }
 bool AlsaOutput::init_alsa_device() {
@@ -87,13 +297,10 @@ bool AlsaOutput::init_alsa_device() {
     int                   error;
     unsigned int          rate        = current_format.sampling_rate;
     bool                  success     = false;
-    constexpr const char* DEVICE_NAME = "hw:0,0";
-    constexpr u64         BUFFER_SIZE = boxten::PCMPACKET_PERIOD * 4;
-    snd_pcm_uframes_t     buffer_size = BUFFER_SIZE;
-    snd_pcm_uframes_t     period_size = boxten::PCMPACKET_PERIOD;
+    snd_pcm_uframes_t     avail_min;
     do {
-        error = snd_pcm_open(&playback_handle.data, DEVICE_NAME, SND_PCM_STREAM_PLAYBACK, 0);
-        TEST_ERROR("cannot open audio device \"" << DEVICE_NAME << "\" (" << snd_strerror(error) << ").");
+        error = snd_pcm_open(&playback_handle, device_config.name.data(), SND_PCM_STREAM_PLAYBACK, 0);
+        TEST_ERROR("cannot open audio device \"" << device_config.name << "\" (" << snd_strerror(error) << ").");
 
         error = snd_pcm_hw_params_malloc(&hw_params);
         TEST_ERROR("cannot allocate hardware parameter structure (" << snd_strerror(error) << ").");
@@ -101,30 +308,67 @@ bool AlsaOutput::init_alsa_device() {
         error = snd_pcm_hw_params_any(playback_handle, hw_params);
         TEST_ERROR("cannot initialize hardware parameter structure (" << snd_strerror(error) << ").");
 
-        error = snd_pcm_hw_params_set_access(playback_handle, hw_params, SND_PCM_ACCESS_RW_INTERLEAVED);
-        TEST_ERROR("cannot set access type (" << snd_strerror(error) << ").");
+        mmap_access = prefer_mmap && snd_pcm_hw_params_set_access(playback_handle, hw_params, SND_PCM_ACCESS_MMAP_INTERLEAVED) == 0;
+        if(!mmap_access) {
+            if(prefer_mmap) {
+                console.message << "\"" << device_config.name << "\" does not support mmap access, falling back to read/write access.";
+            }
+            error = snd_pcm_hw_params_set_access(playback_handle, hw_params, SND_PCM_ACCESS_RW_INTERLEAVED);
+            TEST_ERROR("cannot set access type (" << snd_strerror(error) << ").");
+        }
 
         error = snd_pcm_hw_params_set_format(playback_handle, hw_params, convert_alsa_format());
         TEST_ERROR("cannot set sample format (" << snd_strerror(error) << ").");
 
-        error = snd_pcm_hw_params_set_channels(playback_handle, hw_params, 2);
+        error = snd_pcm_hw_params_set_channels(playback_handle, hw_params, current_format.channels);
         TEST_ERROR("cannot set channel count (" << snd_strerror(error) << ").");
 
         error = snd_pcm_hw_params_set_rate_near(playback_handle, hw_params, &rate, 0);
         TEST_ERROR("cannot set sample rate (" << snd_strerror(error) << ").");
 
+        buffer_size = device_config.buffer.to_frames(rate);
+        period_size = device_config.period.to_frames(rate);
+        if(device_config.timer_scheduling) {
+            // the writer decides when to wake up, so a larger buffer only means fewer wakeups
+            error = snd_pcm_hw_params_get_buffer_size_max(hw_params, &buffer_size);
+            TEST_ERROR("cannot get maximum buffer size (" << snd_strerror(error) << ").");
+        }
         error = snd_pcm_hw_params_set_buffer_size_near(playback_handle, hw_params, &buffer_size);
         TEST_ERROR("cannot set buffer size (" << snd_strerror(error) << ").");
 
         error = snd_pcm_hw_params_set_period_size_near(playback_handle, hw_params, &period_size, NULL);
         TEST_ERROR("cannot set period size (" << snd_strerror(error) << ").");
 
+        period_interrupts = true;
+        if(device_config.timer_scheduling) {
+            if(snd_pcm_hw_params_can_disable_period_wakeup(hw_params) && snd_pcm_hw_params_set_period_wakeup(playback_handle, hw_params, 0) == 0) {
+                period_interrupts = false;
+            } else {
+                console.message << "\"" << device_config.name << "\" cannot disable period interrupts, they are only ignored.";
+            }
+        }
+
         error = snd_pcm_hw_params(playback_handle, hw_params);
         TEST_ERROR("cannot set parameters (" << snd_strerror(error) << ").");
 
         snd_pcm_hw_params_free(hw_params);
         hw_params = nullptr;
 
+        // read/write access goes through a buffer large enough for a whole device buffer
+        unlock_regions(locked_staging);
+        staging.resize(mmap_access ? 0 : buffer_size * current_format.channels * current_format.get_sample_bytewidth());
+        lock_region(staging.data(), staging.size(), locked_staging);
+
+        avail_min       = std::min(device_config.avail_min.value != 0 ? device_config.avail_min.to_frames(rate) : period_size, buffer_size);
+        if(device_config.timer_scheduling) {
+            // the device descriptors then only report an empty buffer or an error
+            avail_min        = buffer_size;
+            watermark_frames = std::min<snd_pcm_uframes_t>(device_config.watermark.to_frames(rate), buffer_size / 2);
+        }
+        start_threshold = std::min(device_config.start_threshold.value != 0 ? device_config.start_threshold.to_frames(rate) : period_size * 2, buffer_size);
+        fetch_frames    = period_size;
+        ring_frames     = buffer_size;
+
         /* 
             tell ALSA to wake us up whenever MIN_FRAME or more frames
             of playback data can be delivered. Also, tell
@@ -136,32 +380,47 @@ bool AlsaOutput::init_alsa_device() {
         error = snd_pcm_sw_params_current(playback_handle, sw_params);
         TEST_ERROR("cannot initialize software parameters structure (" << snd_strerror(error) << ").");
 
-        error = snd_pcm_sw_params_set_avail_min(playback_handle, sw_params, boxten::PCMPACKET_PERIOD * 2);
+        error = snd_pcm_sw_params_set_avail_min(playback_handle, sw_params, avail_min);
         TEST_ERROR("cannot set minimum available count (" << snd_strerror(error) << ").");
 
-        error = snd_pcm_sw_params_set_start_threshold(playback_handle, sw_params, boxten::PCMPACKET_PERIOD * 2);
+        error = snd_pcm_sw_params_set_start_threshold(playback_handle, sw_params, start_threshold);
         TEST_ERROR("cannot set start mode (" << snd_strerror(error) << ").");
 
+        // stamp every status with the monotonic clock so that the position can be interpolated
+        error = snd_pcm_sw_params_set_tstamp_mode(playback_handle, sw_params, SND_PCM_TSTAMP_ENABLE);
+        TEST_ERROR("cannot enable timestamps (" << snd_strerror(error) << ").");
+
+        monotonic_timestamps = snd_pcm_sw_params_set_tstamp_type(playback_handle, sw_params, SND_PCM_TSTAMP_TYPE_MONOTONIC) == 0;
+        if(!monotonic_timestamps) {
+            console.message << "\"" << device_config.name << "\" does not support monotonic timestamps, the position is not interpolated precisely.";
+        }
+
         error = snd_pcm_sw_params(playback_handle, sw_params);
         TEST_ERROR("cannot set software parameters (" << snd_strerror(error) << ").");
 
         snd_pcm_sw_params_free(sw_params);
         sw_params = nullptr;
 
-        /* 
-            the interface will interrupt the kernel every MIN_FRAME frames, and ALSA
-            will wake up this program very soon after that.
+        /*
+            the interface will interrupt the kernel every MIN_FRAME frames, and the
+            writer thread will wake up in poll() very soon after that.
             */
         error = snd_pcm_prepare(playback_handle);
         TEST_ERROR("cannot prepare audio interface for use (" << snd_strerror(error) << ").");
 
-        error = snd_async_add_pcm_handler(&async_handle.data, playback_handle, async_callback, this);
-        TEST_ERROR("failed to add async handler (" << snd_strerror(error) << ").");
-
         success = true;
     } while(0);
 
     if(success) {
+        if(!bit_perfect) {
+            negotiation::publish({{current_format.sample_type}, {current_format.sampling_rate}, {current_format.channels}});
+        }
+        console.message << "\"" << device_config.name << "\": buffer " << buffer_size << " frames, period " << period_size << " frames, "
+                        << (mmap_access ? "mmap" : "read/write") << " access";
+        if(device_config.timer_scheduling) {
+            console.message << ", timer scheduled with a " << watermark_frames << " frames watermark" << (period_interrupts ? "" : " and no period interrupts");
+        }
+        console.message << ".";
         return true;
     } else {
         if(playback_handle != nullptr) {
@@ -178,67 +437,510 @@ bool AlsaOutput::init_alsa_device() {
         return false;
     }
 }
+// keeps the memory the writer reads resident. the writer locks its stack itself in realtime::apply().
+void AlsaOutput::lock_region(const void* address, size_t length, std::vector<std::pair<const void*, size_t>>& locked) {
+    if(!writer_config.lock_memory || length == 0) return;
+    if(const auto result = realtime::lock_memory(address, length); result.success) {
+        locked.emplace_back(address, length);
+    } else {
+        console.error << "writer thread: " << result.description << ".";
+    }
+}
+void AlsaOutput::unlock_regions(std::vector<std::pair<const void*, size_t>>& locked) {
+    for(const auto& [address, length] : locked) {
+        realtime::unlock_memory(address, length);
+    }
+    locked.clear();
+}
+// the slot payloads start at a period, push_pending() locks the ones that grow past it.
+// the buffers they leave behind stay locked until playback stops.
+void AlsaOutput::lock_writer_memory() {
+    unlock_regions(locked_payloads);
+    packets.reserve(period_size * current_format.channels * current_format.get_sample_bytewidth());
+    packets.for_each_buffer([this](const void* address, size_t length) {
+        lock_region(address, length, locked_payloads);
+    });
+}
+void AlsaOutput::unlock_writer_memory() {
+    unlock_regions(locked_staging);
+    unlock_regions(locked_payloads);
+}
 void AlsaOutput::close_alsa_device() {
     if(playback_handle == nullptr) return;
     snd_pcm_drop(playback_handle);
     snd_pcm_close(playback_handle);
     playback_handle = nullptr;
 }
-void AlsaOutput::write_pcm_data() {
-    std::lock_guard<std::mutex> alock(async_handle.lock);
-    std::lock_guard<std::mutex> lock(playback_handle.lock);
+bool AlsaOutput::write_pcm_data() {
+    if(playback_handle == nullptr) return true;
 
     auto frames_to_deliver = snd_pcm_avail_update(playback_handle);
     if(frames_to_deliver < 0) {
-        if(frames_to_deliver == -EPIPE) {
-            auto error = snd_pcm_prepare(playback_handle);
-            if(error < 0) {
-                console.error << "an xrun occured and failed to recover. " << snd_strerror(error);
-                boxten::stop_playback();
-            }
-        } else {
-            console.error << "unknown ALSA avail update return value (" << frames_to_deliver << ").";
+        if(!recover(frames_to_deliver)) return false;
+        frames_to_deliver = snd_pcm_avail_update(playback_handle);
+        if(frames_to_deliver < 0) {
+            console.error << "\"" << device_config.name << "\" keeps failing after recovery (" << snd_strerror(frames_to_deliver) << "), stopping playback.";
+            close_alsa_device();
+            return false;
         }
     }
+    const auto now = nanoseconds_since_epoch(std::chrono::steady_clock::now());
+    if(writer_stats.wakeups == 0) {
+        writer_stats.first_wakeup_nanoseconds = now;
+    }
+    writer_stats.last_wakeup_nanoseconds = now;
+    writer_stats.watermark_frames        = watermark_frames;
+    writer_stats.wakeups += 1;
+    writer_stats.avail_frames += frames_to_deliver;
+    writer_stats.min_avail_frames = std::min<u64>(writer_stats.min_avail_frames, frames_to_deliver);
+    writer_stats.max_avail_frames = std::max<u64>(writer_stats.max_avail_frames, frames_to_deliver);
 
-    while(static_cast<boxten::n_frames>(frames_to_deliver) >= boxten::PCMPACKET_PERIOD) {
-        if(!write_packats(boxten::PCMPACKET_PERIOD)) return;
-        frames_to_deliver = snd_pcm_avail_update(playback_handle);
+    const auto write_start = std::chrono::steady_clock::now();
+    while(frames_to_deliver > 0) {
+        // empty packets are never written, drop them here
+        release_frames(0);
+        auto packet = packets.front();
+        if(packet == nullptr) {
+            // wait for the feeder instead of polling a writable device
+            starved = true;
+            break;
+        }
+        if(front_offset == 0 && packets.is_marked(0) && packets.popped() != flushed_slot) {
+            flush_to_seek();
+            frames_to_deliver = snd_pcm_avail_update(playback_handle);
+            continue;
+        }
+        if(packet->format != current_format) {
+            if(!bit_perfect) {
+                // the resampler takes every sample type, so a rate mismatch means it is not in the chain
+                console.message << "the sound processors did not convert to the open format ("
+                                << (packet->format.sampling_rate != current_format.sampling_rate ? "no resampler" : "no packet format")
+                                << " in front of the output), reopening the device.";
+            }
+            close_alsa_device();
+            current_format = packet->format;
+            if(!init_alsa_device()) {
+                return false;
+            }
+            frames_to_deliver = snd_pcm_avail_update(playback_handle);
+            continue;
+        }
+        // everything queued up to the next format change goes to the device at once
+        const auto written = mmap_access ? write_mmap(frames_to_deliver) : write_staged(frames_to_deliver);
+        if(written < 0) {
+            console.error << "write failed (" << snd_strerror(written) << ").";
+            if(!recover(written)) return false;
+            break;
+        }
+        if(written == 0) break;
+        frames_to_deliver -= written;
     }
-    {
-        snd_pcm_sframes_t delay;
-        auto              error = snd_pcm_delay(playback_handle, &delay);
+    writer_stats.write_nanoseconds += nanoseconds_between(write_start, std::chrono::steady_clock::now());
+    if(restart_early && snd_pcm_state(playback_handle) == SND_PCM_STATE_PREPARED) {
+        const auto avail = snd_pcm_avail_update(playback_handle);
+        if(avail >= 0 && buffer_size - avail >= period_size) {
+            snd_pcm_start(playback_handle);
+            restart_early = false;
+        }
+    } else {
+        restart_early = false;
+    }
+    update_timestamp();
+    if(device_config.timer_scheduling) {
+        arm_timer();
+    }
+    return true;
+}
+// brings the device back after error. an xrun or a suspend is recovered from,
+// anything else means the device is gone, it is closed then and false is returned.
+bool AlsaOutput::recover(snd_pcm_sframes_t error) {
+    switch(error) {
+    case -EPIPE:
+        writer_stats.xrun_timestamps[writer_stats.xruns % Stats::xrun_history] = nanoseconds_since_epoch(std::chrono::steady_clock::now());
+        writer_stats.xruns += 1;
+        console.error << "xrun #" << writer_stats.xruns << " occured.";
+        if(device_config.timer_scheduling && watermark_frames < buffer_size / 2) {
+            // the timer fired too late, wake up earlier from now on
+            watermark_frames = std::min<snd_pcm_uframes_t>(watermark_frames * 2, buffer_size / 2);
+        }
+        error = snd_pcm_prepare(playback_handle);
+        break;
+    case -ESTRPIPE:
+        console.message << "\"" << device_config.name << "\" was suspended, resuming.";
+        // the driver may not support resuming, or not be done with it yet. the stream restarts from scratch then
+        error = snd_pcm_resume(playback_handle);
         if(error < 0) {
-            console.error << "snd_pcm_delay failed (" << snd_strerror(error) << ").";
+            error = snd_pcm_prepare(playback_handle);
         }
-        std::lock_guard<std::mutex> clock(calced_delay.lock);
-        calced_delay = delay;
+        break;
+    }
+    if(error < 0) {
+        console.error << "\"" << device_config.name << "\" failed and cannot recover (" << snd_strerror(error) << "), stopping playback.";
+        close_alsa_device();
+        return false;
+    }
+    return true;
+}
+// sleeps until the device holds only watermark_frames
+void AlsaOutput::arm_timer() {
+    const auto       snapshot = timestamp.load();
+    const auto       frames   = snapshot.delay > watermark_frames ? snapshot.delay - watermark_frames : 0;
+    const auto       ns       = std::max<u64>(frames * 1000000000 / std::max<u32>(snapshot.sampling_rate, 1), 1000000);
+    const itimerspec spec     = {{0, 0}, {static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000)}};
+    if(timerfd_settime(timer_fd, 0, &spec, nullptr) < 0) {
+        console.error << "cannot arm the writer timer (" << strerror(errno) << ").";
     }
 }
+void AlsaOutput::update_timestamp() {
+    snd_pcm_status_t* status;
+    snd_pcm_status_alloca(&status);
+    if(auto error = snd_pcm_status(playback_handle, status); error < 0) {
+        console.error << "snd_pcm_status failed (" << snd_strerror(error) << ").";
+        return;
+    }
+    // the device stamps the status with the monotonic clock, which is what steady_clock reads on linux
+    snd_htimestamp_t stamp;
+    snd_pcm_status_get_htstamp(status, &stamp);
+    auto nanoseconds = static_cast<u64>(stamp.tv_sec) * 1000000000 + stamp.tv_nsec;
+    if(!monotonic_timestamps || nanoseconds == 0) {
+        // not every plugin stamps the status
+        nanoseconds = nanoseconds_since_epoch(std::chrono::steady_clock::now());
+    }
+    const auto delay = snd_pcm_status_get_delay(status);
+    if(!seek_reported && frames_written > seek_frames_written) {
+        // the first frame after the seek plays once the older frames still in the device are gone
+        const auto fresh = frames_written - seek_frames_written;
+        const auto stale = static_cast<u64>(std::max<snd_pcm_sframes_t>(delay, 0)) > fresh ? delay - fresh : 0;
+        const auto now   = nanoseconds_since_epoch(std::chrono::steady_clock::now());
+        const auto since = now > seek_nanoseconds ? now - seek_nanoseconds : 0;
+        const auto ns    = since + stale * 1000000000 / std::max<u32>(current_format.sampling_rate, 1);
+        writer_stats.seeks += 1;
+        writer_stats.seek_latency_nanoseconds += ns;
+        writer_stats.max_seek_latency_nanoseconds = std::max(writer_stats.max_seek_latency_nanoseconds, ns);
+        seek_reported                             = true;
+    }
+    timestamp.store({frames_written, static_cast<boxten::n_frames>(std::max<snd_pcm_sframes_t>(delay, 0)), nanoseconds, current_format.sampling_rate, snd_pcm_status_get_state(status) == SND_PCM_STATE_RUNNING});
+}
+void AlsaOutput::publish_stats(bool wait) {
+    if(wait) {
+        stats.lock.lock();
+    } else if(!stats.lock.try_lock()) {
+        // a reader holds it, the next wakeup publishes again
+        return;
+    }
+    stats.data = writer_stats;
+    stats.lock.unlock();
+}
+AlsaOutput::Stats AlsaOutput::get_stats() {
+    std::lock_guard<std::mutex> lock(stats.lock);
+    auto                        result = stats.data;
+    result.fetch_nanoseconds           = fetch_nanoseconds;
+    return result;
+}
+void AlsaOutput::dump_stats() {
+    const auto data = get_stats();
+    const auto now  = nanoseconds_since_epoch(std::chrono::steady_clock::now());
+    console.message << "ALSA output: " << data.wakeups << " wakeups, " << data.writes << " writes, " << data.xruns << " xruns, "
+                    << "fetch " << data.fetch_nanoseconds / 1000000.0 << " ms, write " << data.write_nanoseconds / 1000000.0 << " ms." << std::endl;
+    if(data.wakeups > 1) {
+        const auto seconds = (data.last_wakeup_nanoseconds - data.first_wakeup_nanoseconds) / 1000000000.0;
+        console.message << (data.wakeups - 1) / seconds << " wakeups per second";
+        if(data.watermark_frames != 0) {
+            console.message << ", watermark " << data.watermark_frames << " frames";
+        }
+        console.message << "." << std::endl;
+    }
+    if(data.wakeups != 0) {
+        console.message << "available frames at wakeup: min " << data.min_avail_frames << ", avg " << data.avail_frames / data.wakeups << ", max " << data.max_avail_frames << "." << std::endl;
+    }
+    if(data.seeks != 0) {
+        console.message << data.seeks << " seeks heard after " << data.seek_latency_nanoseconds / data.seeks / 1000000.0 << " ms on average, "
+                        << data.max_seek_latency_nanoseconds / 1000000.0 << " ms at most." << std::endl;
+    }
+    for(u64 i = data.xruns > Stats::xrun_history ? data.xruns - Stats::xrun_history : 0; i < data.xruns; ++i) {
+        console.message << "xrun #" << i + 1 << ": " << (now - data.xrun_timestamps[i % Stats::xrun_history]) / 1000000 << " ms ago." << std::endl;
+    }
+    for(size_t i = 0; i < Stats::latency_buckets; ++i) {
+        if(data.latency_histogram[i] == 0) continue;
+        if(i + 1 == Stats::latency_buckets) {
+            console.message << "wakeups served in " << (1u << (i - 1)) << " us or more: " << data.latency_histogram[i] << std::endl;
+        } else {
+            console.message << "wakeups served below " << (1u << i) << " us: " << data.latency_histogram[i] << std::endl;
+        }
+    }
+}
+AlsaOutput::Timestamp AlsaOutput::get_timestamp() const {
+    return timestamp.load();
+}
 boxten::n_frames AlsaOutput::output_delay() {
-    std::lock_guard<std::mutex> lock(calced_delay.lock);
-    return calced_delay;
+    const auto snapshot = timestamp.load();
+    auto       delay    = snapshot.delay;
+    if(snapshot.running) {
+        const auto now     = nanoseconds_since_epoch(std::chrono::steady_clock::now());
+        const auto elapsed = now > snapshot.nanoseconds ? now - snapshot.nanoseconds : 0;
+        // the device cannot play more than it holds, the rest of the time it underruns
+        delay -= std::min<boxten::n_frames>(delay, elapsed * snapshot.sampling_rate / 1000000000);
+    }
+    // the packets fetched while the ring was full come after everything queued
+    return delay + packets.get_queued_frames() + pending_frames;
+}
+void AlsaOutput::feeder_main() {
+    while(!finish_writer) {
+        // wait until at least a period is missing, then ask for everything missing at once
+        const auto queued = packets.get_queued_frames();
+        if(pending_next == pending.size() && queued + fetch_frames <= ring_frames) {
+            const auto fetch_start = std::chrono::steady_clock::now();
+            pending                = get_buffer_pcm_packet(ring_frames - queued);
+            pending_next           = 0;
+            pending_frames         = count_frames(pending);
+            fetch_nanoseconds += nanoseconds_between(fetch_start, std::chrono::steady_clock::now());
+        }
+        if(push_pending()) {
+            eventfd_write(data_fd, 1);
+            continue;
+        }
+        // either the ring is full or the sound processors had nothing to give, retry later in the latter case
+        const auto idle = pending_next == pending.size() && packets.get_queued_frames() + fetch_frames <= ring_frames;
+        pollfd     fd   = {space_fd, POLLIN, 0};
+        if(poll(&fd, 1, idle ? 10 : -1) < 0 && errno != EINTR) {
+            console.error << "poll failed (" << strerror(errno) << ").";
+            break;
+        }
+        if(fd.revents & POLLIN) {
+            eventfd_t value;
+            eventfd_read(space_fd, &value);
+        }
+    }
+}
+void AlsaOutput::writer_main() {
+    if(writer_config.is_requested()) {
+        if(const auto result = realtime::apply(writer_config); result.success) {
+            console.message << "writer thread: " << result.description << ".";
+        } else {
+            console.error << "writer thread: " << result.description << ".";
+        }
+    }
+    std::vector<pollfd> fds;
+    bool                device_paused = false;
+    while(!finish_writer) {
+        // the descriptors change whenever the device is reopened for a new format
+        int        n_device_fds = 0;
+        const auto serving      = playback_handle != nullptr && !device_paused && !starved;
+        if(serving) {
+            n_device_fds = snd_pcm_poll_descriptors_count(playback_handle);
+            fds.resize(n_device_fds + 3);
+            n_device_fds = std::max(0, snd_pcm_poll_descriptors(playback_handle, fds.data() + 3, n_device_fds));
+        }
+        fds.resize(n_device_fds + 3);
+        fds[0] = {wake_fd, POLLIN, 0};
+        fds[1] = {starved ? data_fd : -1, POLLIN, 0};
+        fds[2] = {serving && device_config.timer_scheduling ? timer_fd : -1, POLLIN, 0};
+        if(poll(fds.data(), fds.size(), -1) < 0) {
+            if(errno == EINTR) continue;
+            console.error << "poll failed (" << strerror(errno) << ").";
+            break;
+        }
+        if(fds[0].revents & POLLIN) {
+            eventfd_t value;
+            eventfd_read(wake_fd, &value);
+            if(playback_handle == nullptr) continue;
+            if(device_paused != paused) {
+                device_paused = paused;
+                snd_pcm_pause(playback_handle, device_paused);
+                update_timestamp();
+            }
+            // a paused device is flushed on resume, refilling it now would start it
+            if(!device_paused && flush_to_seek()) {
+                if(!write_pcm_data()) {
+                    publish_stats(true);
+                    boxten::stop_playback();
+                    break;
+                }
+                publish_stats(false);
+            }
+            continue;
+        }
+        bool serve = false;
+        if(fds[1].revents & POLLIN) {
+            eventfd_t value;
+            eventfd_read(data_fd, &value);
+            starved = false;
+            // the timer was left unarmed while starved
+            serve = device_config.timer_scheduling && playback_handle != nullptr && !device_paused;
+            if(!serve) continue;
+        }
+        if(fds[2].revents & POLLIN) {
+            u64 expirations;
+            serve = read(timer_fd, &expirations, sizeof(expirations)) == sizeof(expirations);
+        }
+        if(!serve && n_device_fds != 0) {
+            unsigned short revents = 0;
+            snd_pcm_poll_descriptors_revents(playback_handle, fds.data() + 3, n_device_fds, &revents);
+            // POLLERR means an xrun, which write_pcm_data recovers from
+            serve = (revents & (POLLOUT | POLLERR)) != 0;
+        }
+        if(!serve) continue;
+        const auto start = std::chrono::steady_clock::now();
+        if(!write_pcm_data()) {
+            publish_stats(true);
+            boxten::stop_playback();
+            break;
+        }
+        const auto us     = nanoseconds_between(start, std::chrono::steady_clock::now()) / 1000;
+        const auto bucket = std::min<size_t>(std::bit_width(us), Stats::latency_buckets - 1);
+        writer_stats.latency_histogram[bucket] += 1;
+        publish_stats(false);
+    }
+    publish_stats(true);
+}
+void AlsaOutput::wake_writer() {
+    eventfd_write(wake_fd, 1);
+}
+void AlsaOutput::start_writer() {
+    if(writer) return;
+    finish_writer = false;
+    feeder        = boxten::Worker(std::bind(&AlsaOutput::feeder_main, this));
+    writer        = boxten::Worker(std::bind(&AlsaOutput::writer_main, this));
+}
+void AlsaOutput::exit_writer() {
+    finish_writer = true;
+    wake_writer();
+    eventfd_write(space_fd, 1);
+    if(feeder) {
+        feeder.join();
+    }
+    if(!writer) return;
+    if(writer.get_id() == std::this_thread::get_id()) {
+        // the writer itself gave up playback, it exits after returning here
+        writer.detach();
+    } else {
+        writer.join();
+    }
 }
 void AlsaOutput::start_playback() {
     if(playback_handle != nullptr) return;
     auto next_format = get_buffer_pcm_format();
     current_format   = next_format;
     if(!init_alsa_device()) {
-        console.error << "failed to init ALSA device.";
+        // nothing is fetched and no thread runs without a device, init_alsa_device() already reported why
+        unlock_writer_memory();
+        return;
     }
-    write_packats(boxten::PCMPACKET_PERIOD * 2);
-    write_queue.start();
+    paused  = false;
+    starved = false;
+    packets.clear();
+    lock_writer_memory();
+    front_offset      = 0;
+    frames_written    = 0;
+    has_last_end      = false;
+    flushed_slot      = SIZE_MAX;
+    seek_reported     = true;
+    restart_early     = false;
+    writer_stats      = Stats();
+    fetch_nanoseconds = 0;
+    publish_stats(true);
+
+    // queue the first start_threshold frames before the threads run, the device starts as soon as the writer hands them over
+    const auto fetch_start = std::chrono::steady_clock::now();
+    pending                = get_buffer_pcm_packet(start_threshold);
+    pending_next           = 0;
+    pending_frames         = count_frames(pending);
+    fetch_nanoseconds      = nanoseconds_between(fetch_start, std::chrono::steady_clock::now());
+    push_pending();
+    timestamp.store({0, 0, nanoseconds_since_epoch(fetch_start), current_format.sampling_rate, false});
+    start_writer();
 }
 void AlsaOutput::stop_playback() {
-    std::lock_guard<std::mutex> lock(playback_handle.lock);
+    exit_writer();
     close_alsa_device();
-    write_queue.finish();
+    unlock_writer_memory();
+    pending.clear();
+    pending_next   = 0;
+    pending_frames = 0;
+    // the next playback may open the device at another format
+    if(!bit_perfect && !probed_formats.sample_types.empty()) {
+        negotiation::publish(probed_formats);
+    }
+    dump_stats();
 }
 void AlsaOutput::pause_playback() {
-    snd_pcm_pause(playback_handle, 1);
+    // the writer owns the device while it runs
+    paused = true;
+    wake_writer();
 }
 void AlsaOutput::resume_playback() {
-    snd_pcm_pause(playback_handle, 0);
+    paused = false;
+    wake_writer();
+}
+AlsaOutput::AlsaOutput(void* param) : boxten::StreamOutput(param), packets(ring_slots), wake_fd(eventfd(0, EFD_CLOEXEC)), data_fd(eventfd(0, EFD_CLOEXEC)), space_fd(eventfd(0, EFD_CLOEXEC)), timer_fd(timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) {
+    if(wake_fd < 0 || data_fd < 0 || space_fd < 0 || timer_fd < 0) {
+        console.error << "cannot create eventfd (" << strerror(errno) << ").";
+    }
+    if(i64 mmap_s; get_number("mmap", mmap_s)) {
+        prefer_mmap = mmap_s != 0;
+    }
+    if(i64 bit_perfect_s; get_number("bit perfect", bit_perfect_s)) {
+        bit_perfect = bit_perfect_s != 0;
+    }
+    if(i64 priority; get_number("realtime priority", priority) && priority > 0) {
+        writer_config.policy   = SCHED_FIFO;
+        writer_config.priority = priority;
+    }
+    if(i64 lock_memory; get_number("lock memory", lock_memory)) {
+        writer_config.lock_memory = lock_memory != 0;
+    }
+    if(i64 timer_scheduling; get_number("timer scheduling", timer_scheduling)) {
+        device_config.timer_scheduling = timer_scheduling != 0;
+    }
+    device::apply_profile("default", device_config);
+    if(nlohmann::json conf; load_configuration(conf)) {
+        if(boxten::type_check("device", boxten::JSON_TYPE::STRING, conf)) {
+            device_config.name = conf["device"].get<std::string>();
+        }
+        if(boxten::type_check("profile", boxten::JSON_TYPE::STRING, conf) && !device::apply_profile(conf["profile"].get<std::string>(), device_config)) {
+            console.error << "unknown profile \"" << conf["profile"].get<std::string>() << "\", using default.";
+        }
+        if(writer_config.policy != SCHED_OTHER && boxten::type_check("realtime policy", boxten::JSON_TYPE::STRING, conf)) {
+            if(const auto policy = realtime::policy_from_name(conf["realtime policy"].get<std::string>()); policy != SCHED_OTHER) {
+                writer_config.policy = policy;
+            } else {
+                console.error << "unknown realtime policy, using fifo.";
+            }
+        }
+        if(boxten::array_type_check("cpu affinity", boxten::JSON_TYPE::NUMBER, conf)) {
+            writer_config.cpus = conf["cpu affinity"].get<std::vector<i64>>();
+        }
+    }
+    // explicit lengths override the profile, in frames or in microseconds
+    const auto load_length = [this](const std::string& key, device::Length& length) {
+        if(i64 value; get_number((key + " frames").data(), value) && value > 0) {
+            length = device::Length::frames(value);
+        } else if(get_number((key + " us").data(), value) && value > 0) {
+            length = device::Length::microseconds(value);
+        }
+    };
+    load_length("buffer", device_config.buffer);
+    load_length("period", device_config.period);
+    load_length("avail min", device_config.avail_min);
+    load_length("start threshold", device_config.start_threshold);
+    load_length("watermark", device_config.watermark);
+    publish_device_formats();
+}
+AlsaOutput::~AlsaOutput() {
+    exit_writer();
+    close_alsa_device();
+    unlock_writer_memory();
+    for(auto fd : {wake_fd, data_fd, space_fd, timer_fd}) {
+        if(fd >= 0) {
+            close(fd);
+        }
+    }
+    negotiation::withdraw();
+    set_number("mmap", prefer_mmap);
+    set_number("bit perfect", bit_perfect);
+    set_number("realtime priority", writer_config.policy != SCHED_OTHER ? writer_config.priority : 0);
+    set_number("lock memory", writer_config.lock_memory);
+    set_number("timer scheduling", device_config.timer_scheduling);
 }
 
 BOXTEN_MODULE({"ALSA output", boxten::COMPONENT_TYPE::STREAM_OUTPUT, CATALOGUE_CALLBACK(AlsaOutput)})
@@ -1,8 +1,9 @@
 #pragma once
 #include "type.hpp"
 #include <alsa/global.h>
+#include <array>
+#include <atomic>
 #include <mutex>
-#include <thread>
 #include <vector>
 
 #include <alsa/asoundlib.h>
@@ -10,41 +11,161 @@
 
 #include <config.h>
 
-class AlsaOutput;
-enum class AsyncCallbackCommands {
-    Write,
-};
-class WriteQueue : public boxten::QueueThread<AsyncCallbackCommands> {
-  private:
-    AlsaOutput& owner;
-    void        proc(std::vector<AsyncCallbackCommands> queue) override;
+#include "device-config.hpp"
+#include "format-negotiation.hpp"
+#include "packet-ring.hpp"
+#include "realtime.hpp"
+#include "seqlock.hpp"
 
-  public:
-    WriteQueue(AlsaOutput& owner) : owner(owner) {}
-};
+// channels are written in the order of the packets, which is wav order for the inputs in this tree.
+// alsa orders 5.1 and 7.1 differently, so more than 2 channels need the "channel map" of the packet format.
 class AlsaOutput : public boxten::StreamOutput {
+  public:
+    struct Stats {
+        static constexpr size_t xrun_history    = 16;
+        static constexpr size_t latency_buckets = 16;
+
+        u64 wakeups           = 0;
+        u64 avail_frames      = 0; // frames the device could take at each wakeup, summed
+        u64 min_avail_frames  = UINT64_MAX;
+        u64 max_avail_frames  = 0;
+        u64 fetch_nanoseconds = 0; // time spent in get_buffer_pcm_packet
+        u64 write_nanoseconds = 0; // time spent handing packets to the device
+        u64 writes            = 0; // snd_pcm_writei or snd_pcm_mmap_commit calls
+
+        // steady clock time of the first and latest wakeups, for the wakeup rate
+        u64 first_wakeup_nanoseconds = 0;
+        u64 last_wakeup_nanoseconds  = 0;
+        u64 watermark_frames         = 0; // with timer scheduling, raised on every xrun
+
+        // from the first packet after a seek reaching the output to it being heard
+        u64 seeks                        = 0;
+        u64 seek_latency_nanoseconds     = 0;
+        u64 max_seek_latency_nanoseconds = 0;
+
+        u64 xruns = 0;
+
+        // steady clock time in ns of the latest xruns, the oldest one at xruns % xrun_history
+        std::array<u64, xrun_history> xrun_timestamps = {};
+        // time from the wakeup to the device being filled.
+        // bucket n counts wakeups served in [2^(n-1), 2^n) us, bucket 0 below 1 us, the last one everything longer.
+        std::array<u64, latency_buckets> latency_histogram = {};
+    };
+
+    // the device state at the last wakeup of the writer.
+    // the current delay is interpolated from it without asking the device again.
+    struct Timestamp {
+        u64              frames_written = 0; // frames handed to the device since playback started
+        boxten::n_frames delay          = 0; // frames in the device at the time of the snapshot
+        u64              nanoseconds    = 0; // steady clock time of the snapshot
+        u32              sampling_rate  = 0;
+        bool             running        = false; // the device consumes frames, so the delay shrinks with time
+    };
+
   private:
-    boxten::SafeVar<snd_pcm_t*>           playback_handle = nullptr;
-    boxten::SafeVar<snd_async_handler_t*> async_handle    = nullptr;
-    boxten::PCMFormat                     current_format;
-    boxten::SafeVar<boxten::n_frames>     calced_delay = 0;
-    WriteQueue                            write_queue;
+    snd_pcm_t*                    playback_handle = nullptr; // owned by the writer while it runs
+    boxten::PCMFormat             current_format;
+    SeqLock<Timestamp>            timestamp;
+    u64                           frames_written    = 0; // writer only
+    std::atomic<u64>              fetch_nanoseconds = 0;
+    boxten::SafeVar<Stats>        stats             = Stats();
+
+    // the feeder thread fetches packets from the sound processors and hands them to
+    // the writer thread through packets, so the writer never waits for a lock or an
+    // allocation of the non real-time side.
+    // the writer sleeps in poll() on the device, wake_fd and, once it ran out of packets, data_fd.
+    // wake_fd interrupts it for stop, pause and resume, data_fd tells it new packets arrived and
+    // space_fd tells the feeder that a slot was freed.
+    PacketRing                         packets;
+    std::vector<boxten::PCMPacketUnit> pending; // fetched but not queued yet, feeder only
+    size_t                             pending_next   = 0;
+    std::atomic<u64>                   pending_frames = 0; // frames of pending not queued yet, counted in output_delay()
+    std::atomic<u64>                   fetch_frames   = 0;
+    std::atomic<u64>                   ring_frames    = 0; // the feeder keeps this many frames queued
+    u64                                front_offset   = 0; // frames of packets.front() already written, writer only
+    std::vector<u8>                    staging;            // read/write access only, the frames of one snd_pcm_writei
+    bool                               starved      = false;
+    Stats                              writer_stats; // writer only, copied to stats when nobody reads them
+    boxten::Worker                     writer;
+    boxten::Worker                     feeder;
+    int                                wake_fd;
+    int                                data_fd;
+    int                                space_fd;
+    int                                timer_fd; // timer scheduling only
+    std::atomic<bool>                  finish_writer = false;
+    std::atomic<bool>                  paused        = false; // the writer pauses the device accordingly
+
+    // the feeder marks packets following a seek in packets, the writer then drops
+    // everything older from the ring and the device.
+    u64              last_end            = 0; // original_frame_pos[1] of the latest packet, feeder only
+    bool             has_last_end        = false;
+    std::atomic<u64> seek_nanoseconds    = 0;        // steady clock time the latest seek was noticed
+    size_t           flushed_slot        = SIZE_MAX; // writer only from here
+    u64              seek_frames_written = 0;
+    bool             seek_reported       = true;
+    bool             restart_early       = false; // start the device after a period instead of start_threshold
+
+    realtime::Config                            writer_config;
+    // regions locked for the writer until playback stops.
+    // staging is locked by the writer, the slot payloads by the feeder, while they run.
+    std::vector<std::pair<const void*, size_t>> locked_staging;
+    std::vector<std::pair<const void*, size_t>> locked_payloads;
+
+    // mmap access is tried first unless disabled, the device may still refuse it
+    bool              prefer_mmap          = true;
+    bool              mmap_access          = false;
+    bool              monotonic_timestamps = false;
+    device::Config    device_config;
+
+    // unless bit perfect, the device stays open at the format of the first packet and
+    // only that format is published while it is open, so that the sound processors
+    // convert later tracks to it instead of the device being reopened between them.
+    // rate changes need the resampler in the chain, the sample type and channels the packet format.
+    bool                       bit_perfect = false;
+    negotiation::DeviceFormats probed_formats;
+
+    snd_pcm_uframes_t buffer_size       = 0;
+    snd_pcm_uframes_t period_size       = 0;
+    snd_pcm_uframes_t start_threshold   = 0;
+    snd_pcm_uframes_t watermark_frames  = 0;
+    bool              period_interrupts = true;
 
     snd_pcm_format_t convert_alsa_format();
-    bool             write_packats(size_t frames);
+    snd_pcm_uframes_t gather_frames(u8* dst, snd_pcm_uframes_t frames);
+    void             release_frames(snd_pcm_uframes_t frames);
+    snd_pcm_sframes_t write_mmap(snd_pcm_uframes_t frames);
+    snd_pcm_sframes_t write_staged(snd_pcm_uframes_t frames);
+    bool             follows_seek(const boxten::PCMPacketUnit& packet);
+    bool             push_pending(); // returns true if any packet was queued
+    bool             flush_to_seek();
     bool             init_alsa_device();
     void             close_alsa_device();
+    void             lock_region(const void* address, size_t length, std::vector<std::pair<const void*, size_t>>& locked);
+    void             unlock_regions(std::vector<std::pair<const void*, size_t>>& locked);
+    void             lock_writer_memory(); // the slot payloads, before the threads run
+    void             unlock_writer_memory();
+    void             publish_device_formats();
+    bool             write_pcm_data(); // returns false if playback cannot continue
+    bool             recover(snd_pcm_sframes_t error);
+    void             update_timestamp();
+    void             arm_timer();
+    void             publish_stats(bool wait);
+    void             feeder_main();
+    void             writer_main();
+    void             wake_writer();
+    void             start_writer();
+    void             exit_writer();
 
   public:
-    void write_pcm_data();
-    void add_queue();
-
+    Stats            get_stats();
+    Timestamp        get_timestamp() const;
+    void             dump_stats(); // writes the stats to the console
     boxten::n_frames output_delay() override;
     void             start_playback() override;
     void             stop_playback() override;
     void             pause_playback() override;
     void             resume_playback() override;
-    AlsaOutput(void* param) : boxten::StreamOutput(param), write_queue(*this) {}
-    ~AlsaOutput() override {}
+    AlsaOutput(void* param);
+    ~AlsaOutput() override;
 };
 
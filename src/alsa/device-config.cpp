@@ -0,0 +1,41 @@
+#include <libboxten.hpp>
+
+#include "device-config.hpp"
+
+namespace device {
+namespace {
+const struct {
+    const char* name;
+    Length      buffer;
+    Length      period;
+    Length      avail_min;
+    Length      start_threshold;
+} profiles[] = {
+    {"default", Length::frames(boxten::PCMPACKET_PERIOD * 4), Length::frames(boxten::PCMPACKET_PERIOD), Length::frames(boxten::PCMPACKET_PERIOD * 2), Length::frames(boxten::PCMPACKET_PERIOD * 2)},
+    {"low-latency", Length::microseconds(10000), Length::microseconds(2500), {}, {}},
+    {"power-saver", Length::microseconds(2000000), Length::microseconds(500000), {}, {}},
+};
+} // namespace
+
+snd_pcm_uframes_t Length::to_frames(u32 rate) const {
+    return is_time ? value * rate / 1000000 : value;
+}
+Length Length::frames(u64 value) {
+    return {value, false};
+}
+Length Length::microseconds(u64 value) {
+    return {value, true};
+}
+bool apply_profile(const std::string& profile, Config& config) {
+    for(const auto& p : profiles) {
+        if(profile == p.name) {
+            config.buffer          = p.buffer;
+            config.period          = p.period;
+            config.avail_min       = p.avail_min;
+            config.start_threshold = p.start_threshold;
+            return true;
+        }
+    }
+    return false;
+}
+} // namespace device
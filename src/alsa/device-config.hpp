@@ -0,0 +1,39 @@
+#pragma once
+#include <alsa/asoundlib.h>
+#include <string>
+
+#include "type.hpp"
+
+// which device to open and how its ring buffer is laid out
+namespace device {
+// a length in frames, or in microseconds to keep latency independent of the sampling rate
+struct Length {
+    u64  value   = 0;
+    bool is_time = false;
+
+    snd_pcm_uframes_t to_frames(u32 rate) const;
+    static Length     frames(u64 value);
+    static Length     microseconds(u64 value);
+};
+
+struct Config {
+    std::string name = "hw:0,0";
+    Length      buffer;
+    Length      period;
+    Length      avail_min;       // 0 to wake up every period
+    Length      start_threshold; // 0 to start once two periods are queued
+
+    // wake up on a timer computed from the delay instead of on period interrupts.
+    // the buffer then is the largest the device allows, the lengths above only set how much
+    // is fetched at once and when playback starts.
+    bool   timer_scheduling = false;
+    Length watermark        = Length::microseconds(20000); // frames left in the device when the timer fires
+};
+
+// fills the lengths of config from a named profile:
+//  "default"     : 4 periods of PCMPACKET_PERIOD frames
+//  "low-latency" : 10 ms buffer, 2.5 ms periods
+//  "power-saver" : 2 s buffer, 500 ms periods
+// returns false if there is no such profile.
+bool apply_profile(const std::string& profile, Config& config);
+} // namespace device
@@ -0,0 +1,106 @@
+#pragma once
+#include <atomic>
+#include <vector>
+
+#include <libboxten.hpp>
+
+// a lock-free queue of packets with one producer and one consumer.
+// slots are filled and read in place, so packet buffers are only allocated and
+// freed by the producer and the consumer never touches the heap.
+// every slot keeps its own payload buffer, packets are copied into it, so that the
+// consumer reads from the same memory over and over and the producer can lock it once.
+class PacketRing {
+  private:
+    std::vector<boxten::PCMPacketUnit> slots;
+    std::vector<u8>                    marks; // set by push(), published with the slot
+    std::atomic<size_t>                head          = 0; // slots pushed, written by the producer
+    std::atomic<size_t>                tail          = 0; // slots popped, written by the consumer
+    std::atomic<u64>                   queued_frames = 0;
+
+  public:
+    // producer side.
+    // returns the slot to fill, or nullptr if the ring is full.
+    boxten::PCMPacketUnit* back() {
+        const auto h = head.load(std::memory_order_relaxed);
+        if(h - tail.load(std::memory_order_acquire) == slots.size()) return nullptr;
+        return &slots[h % slots.size()];
+    }
+    // copies packet into the slot returned by back(), reusing the payload buffer of the slot.
+    // returns true if that buffer had to grow, it is at another address then.
+    bool fill(boxten::PCMPacketUnit&& packet) {
+        auto&      slot   = slots[head.load(std::memory_order_relaxed) % slots.size()];
+        auto       buffer = std::move(slot.pcm);
+        const auto grows  = buffer.capacity() < packet.pcm.size();
+        buffer.assign(packet.pcm.begin(), packet.pcm.end());
+        slot = std::move(packet);
+        // the buffer of the packet is freed with it
+        slot.pcm.swap(buffer);
+        return grows;
+    }
+    // publishes the slot returned by back(), optionally marking it for the consumer
+    void push(bool mark = false) {
+        const auto h = head.load(std::memory_order_relaxed);
+        marks[h % slots.size()] = mark;
+        queued_frames.fetch_add(slots[h % slots.size()].get_frames(), std::memory_order_relaxed);
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    // consumer side.
+    // returns the oldest packet, or nullptr if the ring is empty.
+    boxten::PCMPacketUnit* front() {
+        const auto t = tail.load(std::memory_order_relaxed);
+        if(head.load(std::memory_order_acquire) == t) return nullptr;
+        return &slots[t % slots.size()];
+    }
+    // returns the packet n places behind the front one, or nullptr if there are not that many
+    boxten::PCMPacketUnit* peek(size_t n) {
+        const auto t = tail.load(std::memory_order_relaxed);
+        if(head.load(std::memory_order_acquire) - t <= n) return nullptr;
+        return &slots[(t + n) % slots.size()];
+    }
+    // whether the packet n places behind the front one was pushed with a mark.
+    // peek(n) must have returned it.
+    bool is_marked(size_t n) const {
+        return marks[(tail.load(std::memory_order_relaxed) + n) % slots.size()];
+    }
+    // frames of the front packet have been played, the packet itself stays until pop()
+    void consume(u64 frames) {
+        queued_frames.fetch_sub(frames, std::memory_order_relaxed);
+    }
+    // releases the slot returned by front() back to the producer
+    void pop() {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // slots popped since the last clear(), consumer side.
+    // tells packets apart across calls, the front one is always number popped().
+    size_t popped() const {
+        return tail.load(std::memory_order_relaxed);
+    }
+    // frames pushed and not consumed yet
+    u64 get_queued_frames() const {
+        return queued_frames.load(std::memory_order_relaxed);
+    }
+    // drops every packet. neither side may be running.
+    void clear() {
+        head          = 0;
+        tail          = 0;
+        queued_frames = 0;
+    }
+
+    // grows the payload buffer of every slot to at least bytes. neither side may be running.
+    void reserve(size_t bytes) {
+        for(auto& slot : slots) {
+            slot.pcm.reserve(bytes);
+        }
+    }
+    // calls func with the address and the capacity of the payload buffer of every slot, producer side
+    template <typename Func>
+    void for_each_buffer(Func func) const {
+        for(const auto& slot : slots) {
+            func(static_cast<const void*>(slot.pcm.data()), slot.pcm.capacity());
+        }
+    }
+
+    PacketRing(size_t n_slots) : slots(n_slots), marks(n_slots) {}
+};
@@ -0,0 +1,102 @@
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+#include <sys/mman.h>
+
+#include "realtime.hpp"
+
+namespace realtime {
+namespace {
+constexpr size_t prefault_stack_size = 256 * 1024;
+
+const char* policy_name(int policy) {
+    switch(policy) {
+    case SCHED_FIFO:
+        return "SCHED_FIFO";
+    case SCHED_RR:
+        return "SCHED_RR";
+    default:
+        return "SCHED_OTHER";
+    }
+}
+
+// touches and locks the stack the thread is going to use, so that no page fault happens on the write path.
+// the frame of this function lies right below the caller, where the deeper calls of the thread will be.
+[[gnu::noinline]] int prefault_stack() {
+    volatile u8 stack[prefault_stack_size];
+    for(size_t i = 0; i < prefault_stack_size; i += 4096) {
+        stack[i] = 0;
+    }
+    return mlock(const_cast<u8*>(stack), prefault_stack_size) == 0 ? 0 : errno;
+}
+
+std::string describe_error(const char* what, int error) {
+    return std::string("cannot ") + what + " (" + std::strerror(error) + ")";
+}
+} // namespace
+
+bool Config::is_requested() const {
+    return policy != SCHED_OTHER || !cpus.empty() || lock_memory;
+}
+Result apply(const Config& config) {
+    Result result = {true, ""};
+    const auto append = [&result](bool success, const std::string& description) {
+        result.success &= success;
+        if(!result.description.empty()) result.description += ", ";
+        result.description += description;
+    };
+
+    if(config.policy != SCHED_OTHER) {
+        const int min      = sched_get_priority_min(config.policy);
+        const int max      = sched_get_priority_max(config.policy);
+        const int priority = config.priority < min ? min : config.priority > max ? max : config.priority;
+        sched_param param  = {};
+        param.sched_priority = priority;
+        if(const auto error = pthread_setschedparam(pthread_self(), config.policy, &param); error != 0) {
+            append(false, describe_error((std::string("set ") + policy_name(config.policy)).data(), error));
+        } else {
+            append(true, std::string(policy_name(config.policy)) + " priority " + std::to_string(priority));
+        }
+    }
+    if(!config.cpus.empty()) {
+        cpu_set_t   set;
+        std::string list;
+        CPU_ZERO(&set);
+        for(const auto cpu : config.cpus) {
+            if(cpu < 0 || cpu >= CPU_SETSIZE) continue;
+            CPU_SET(cpu, &set);
+            list += (list.empty() ? "" : ",") + std::to_string(cpu);
+        }
+        if(const auto error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set); error != 0) {
+            append(false, describe_error("set cpu affinity", error));
+        } else {
+            append(true, "cpus " + list);
+        }
+    }
+    if(config.lock_memory) {
+        if(const auto error = prefault_stack(); error != 0) {
+            append(false, describe_error("lock the stack", error));
+        } else {
+            append(true, "stack locked");
+        }
+    }
+    return result;
+}
+Result lock_memory(const void* address, size_t length) {
+    if(length == 0) return {true, ""};
+    // mlock faults every page in
+    if(mlock(address, length) != 0) {
+        return {false, describe_error(("lock " + std::to_string(length) + " bytes").data(), errno)};
+    }
+    return {true, std::to_string(length) + " bytes locked"};
+}
+void unlock_memory(const void* address, size_t length) {
+    if(length == 0) return;
+    munlock(address, length);
+}
+int policy_from_name(const std::string& name) {
+    if(name == "fifo") return SCHED_FIFO;
+    if(name == "rr") return SCHED_RR;
+    return SCHED_OTHER;
+}
+} // namespace realtime
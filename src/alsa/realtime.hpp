@@ -0,0 +1,35 @@
+#pragma once
+#include <sched.h>
+#include <string>
+#include <vector>
+
+#include "type.hpp"
+
+// scheduling and memory residency of the thread feeding the device
+namespace realtime {
+struct Config {
+    int              policy      = SCHED_OTHER; // SCHED_FIFO or SCHED_RR to enable real-time scheduling
+    int              priority    = 0;
+    std::vector<i64> cpus;                      // empty to run on any cpu
+    bool             lock_memory = false;       // lock and pre-fault the stack of the thread
+
+    bool is_requested() const;
+};
+
+struct Result {
+    bool        success;
+    std::string description;
+};
+
+// applies config to the calling thread.
+// failures are described in the result and leave the thread running as it was.
+Result apply(const Config& config);
+
+// keeps length bytes from address resident, so that a real-time thread never faults on them.
+// only the given range is locked, the rest of the process is left alone.
+Result lock_memory(const void* address, size_t length);
+void   unlock_memory(const void* address, size_t length);
+
+// "fifo" or "rr" to SCHED_FIFO or SCHED_RR, SCHED_OTHER otherwise
+int policy_from_name(const std::string& name);
+} // namespace realtime
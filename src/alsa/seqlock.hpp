@@ -0,0 +1,55 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include <libboxten.hpp>
+
+// publishes a small value from one writer to any number of readers without locking.
+// the writer never waits, readers retry while a store is in progress.
+template <class T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+  private:
+    static constexpr size_t words = (sizeof(T) + sizeof(u64) - 1) / sizeof(u64);
+
+    std::atomic<u64>                    sequence = 0; // odd while a store is in progress
+    std::array<std::atomic<u64>, words> data     = {};
+
+  public:
+    // only one thread may store
+    void store(const T& value) {
+        std::array<u64, words> buffer = {};
+        std::memcpy(buffer.data(), &value, sizeof(T));
+        const auto s = sequence.load(std::memory_order_relaxed);
+        sequence.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for(size_t i = 0; i < words; ++i) {
+            data[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        sequence.store(s + 2, std::memory_order_release);
+    }
+    T load() const {
+        std::array<u64, words> buffer;
+        while(true) {
+            const auto s = sequence.load(std::memory_order_acquire);
+            if(s & 1) continue;
+            for(size_t i = 0; i < words; ++i) {
+                buffer[i] = data[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if(sequence.load(std::memory_order_relaxed) == s) break;
+        }
+        // T may have default member initializers, so it is built from the bytes instead of being written over
+        std::array<std::byte, sizeof(T)> bytes;
+        std::memcpy(bytes.data(), buffer.data(), sizeof(T));
+        return std::bit_cast<T>(bytes);
+    }
+    SeqLock(const T& value = T()) {
+        store(value);
+    }
+};
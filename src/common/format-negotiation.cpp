@@ -0,0 +1,41 @@
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+#include "format-negotiation.hpp"
+
+namespace negotiation {
+namespace {
+std::mutex                   lock;
+std::optional<DeviceFormats> device_formats;
+std::atomic<u64>             generation = 0;
+} // namespace
+
+bool DeviceFormats::accepts(boxten::SampleType sample_type) const {
+    return std::find(sample_types.begin(), sample_types.end(), sample_type) != sample_types.end();
+}
+bool DeviceFormats::accepts(u32 sampling_rate) const {
+    return std::find(sampling_rates.begin(), sampling_rates.end(), sampling_rate) != sampling_rates.end();
+}
+bool DeviceFormats::accepts_channels(u32 channels) const {
+    return channel_counts.empty() || std::find(channel_counts.begin(), channel_counts.end(), channels) != channel_counts.end();
+}
+
+void publish(DeviceFormats formats) {
+    std::lock_guard<std::mutex> glock(lock);
+    device_formats = std::move(formats);
+    generation += 1;
+}
+void withdraw() {
+    std::lock_guard<std::mutex> glock(lock);
+    device_formats.reset();
+    generation += 1;
+}
+std::optional<DeviceFormats> get_device_formats() {
+    std::lock_guard<std::mutex> glock(lock);
+    return device_formats;
+}
+u64 get_generation() {
+    return generation;
+}
+} // namespace negotiation
@@ -0,0 +1,32 @@
+#pragma once
+#include <optional>
+#include <vector>
+
+#include <libboxten.hpp>
+
+// lets the output module tell the sound processors what the device plays natively,
+// so that packets are converted at most once and only when needed.
+// every module links the same shared library, so there is one instance per process.
+namespace negotiation {
+struct DeviceFormats {
+    std::vector<boxten::SampleType> sample_types;
+    std::vector<u32>                sampling_rates;
+    std::vector<u32>                channel_counts; // empty if unknown
+
+    bool accepts(boxten::SampleType sample_type) const;
+    bool accepts(u32 sampling_rate) const;
+    bool accepts_channels(u32 channels) const;
+};
+
+// replaces the published formats. called by the output module after probing the device.
+void publish(DeviceFormats formats);
+
+// clears the published formats. called when the output module goes away.
+void withdraw();
+
+// the formats published last, if any.
+std::optional<DeviceFormats> get_device_formats();
+
+// increases whenever publish() or withdraw() is called, so callers can cache their decisions.
+u64 get_generation();
+} // namespace negotiation
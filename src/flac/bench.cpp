@@ -0,0 +1,117 @@
+// microbenchmark and verification for the write_callback interleavers.
+// packs libFLAC-style planar blocks the way Decoder::write_callback does, once with
+// the old per-byte emplace_back loop and once with the interleave kernels, and
+// reports the output rate of each in MB/s.
+// exits with non-zero status if a kernel differs from the per-byte loop.
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "interleave.hpp"
+
+namespace {
+constexpr size_t blocksize        = 4096; // the libFLAC default for 44.1/48kHz streams
+constexpr size_t widths[]         = {1, 2, 3, 4};
+constexpr size_t channel_counts[] = {1, 2, 6};
+constexpr size_t min_bytes        = 1 << 28; // per measurement
+
+using Planes = std::vector<std::vector<int32_t>>;
+
+// random samples that fit in bytewidth bytes, as libFLAC hands them out
+Planes make_planes(size_t bytewidth, size_t channels, std::mt19937& engine) {
+    const int32_t                          max = static_cast<int32_t>((int64_t(1) << (bytewidth * 8 - 1)) - 1);
+    std::uniform_int_distribution<int32_t> dist(-max - 1, max);
+    Planes                                 result(channels, std::vector<int32_t>(blocksize));
+    for(auto& plane : result) {
+        for(auto& s : plane) {
+            s = dist(engine);
+        }
+    }
+    return result;
+}
+
+// the interleaver write_callback used to have
+void per_byte(const int32_t* const planes[], size_t channels, size_t bytewidth, std::vector<uint8_t>& buffer) {
+    for(uint32_t b = 0; b < blocksize; ++b) {
+        for(uint32_t c = 0; c < channels; ++c) {
+            const int32_t& block = planes[c][b];
+            for(size_t l = 0; l < bytewidth; ++l) {
+                buffer.emplace_back(reinterpret_cast<const uint8_t*>(&block)[l]);
+            }
+        }
+    }
+}
+
+void bulk(const int32_t* const planes[], size_t channels, size_t bytewidth, std::vector<uint8_t>& buffer) {
+    const size_t old_size = buffer.size();
+    buffer.resize(old_size + blocksize * channels * bytewidth);
+    interleave::get_kernel(bytewidth)(planes, channels, blocksize, buffer.data() + old_size);
+}
+
+// a read_frames() call gathers a few blocks into a fresh vector, so the buffer
+// is rebuilt from empty every few frames like the decoder does.
+template <typename Func>
+double measure(Func func, const int32_t* const planes[], size_t channels, size_t bytewidth) {
+    constexpr size_t blocks_per_read = 4;
+    const size_t     block_bytes     = blocksize * channels * bytewidth;
+    const size_t     reads           = (min_bytes + block_bytes * blocks_per_read - 1) / (block_bytes * blocks_per_read);
+    const auto       start           = std::chrono::steady_clock::now();
+    for(size_t r = 0; r < reads; ++r) {
+        std::vector<uint8_t> buffer;
+        for(size_t i = 0; i < blocks_per_read; ++i) {
+            func(planes, channels, bytewidth, buffer);
+        }
+        asm volatile("" : : "r"(buffer.data()) : "memory");
+    }
+    const auto   end     = std::chrono::steady_clock::now();
+    const double elapsed = std::chrono::duration<double>(end - start).count();
+    return static_cast<double>(reads * blocks_per_read * block_bytes) / elapsed / 1e6;
+}
+} // namespace
+
+int main() {
+    std::mt19937 engine(0);
+    size_t       failures = 0;
+
+    std::printf("simd: %s\n", interleave::get_simd_instruction_set());
+    std::printf("%5s %3s %12s %12s %8s\n", "bytes", "ch", "before MB/s", "after MB/s", "speedup");
+    for(auto bytewidth : widths) {
+        for(auto channels : channel_counts) {
+            const auto                  planes = make_planes(bytewidth, channels, engine);
+            std::vector<const int32_t*> pointers;
+            for(const auto& plane : planes) {
+                pointers.emplace_back(plane.data());
+            }
+
+            // the kernels must produce the bytes the per-byte loop did, also after unaligned lengths
+            std::vector<uint8_t> expected;
+            std::vector<uint8_t> result;
+            per_byte(pointers.data(), channels, bytewidth, expected);
+            bulk(pointers.data(), channels, bytewidth, result);
+            for(size_t frames = 1; frames < 20; ++frames) {
+                std::vector<uint8_t> tail(frames * channels * bytewidth);
+                interleave::get_kernel(bytewidth)(pointers.data(), channels, frames, tail.data());
+                if(!std::equal(tail.begin(), tail.end(), expected.begin())) {
+                    result.clear();
+                }
+            }
+            if(result != expected) {
+                std::printf("FAIL: %zu bytes %zu channels differs from the per-byte loop\n", bytewidth, channels);
+                failures += 1;
+            }
+
+            const double before = measure(per_byte, pointers.data(), channels, bytewidth);
+            const double after  = measure(bulk, pointers.data(), channels, bytewidth);
+            std::printf("%5zu %3zu %12.1f %12.1f %7.1fx\n", bytewidth, channels, before, after, after / before);
+        }
+    }
+    if(failures != 0) {
+        std::printf("%zu verification(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("all verifications passed\n");
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "decoder.hpp"
+#include "interleave.hpp"
 #include <FLAC/stream_decoder.h>
 #include <stdexcept>
 
@@ -21,13 +22,10 @@ Decoder::write_callback(const FLAC__Frame* frame, const FLAC__int32* const buffe
                     : frame->header.number.frame_number;
             write_callback_position = nullptr;
         }
-        for(uint32_t b = 0; b < frame->header.blocksize; ++b) {
-            for(uint32_t c = 0; c < frame->header.channels; ++c) {
-                const FLAC__int32& block = buffer[c][b];
-                for(size_t l = 0; l < bytewidth; ++l) {
-                    write_callback_buffer->emplace_back(reinterpret_cast<const uint8_t*>(&block)[l]);
-                }
-            }
+        if(bytewidth != 0 && bytewidth <= 4) {
+            const size_t old_size = write_callback_buffer->size();
+            write_callback_buffer->resize(old_size + frame->header.blocksize * frame->header.channels * bytewidth);
+            interleave::get_kernel(bytewidth)(buffer, frame->header.channels, frame->header.blocksize, write_callback_buffer->data() + old_size);
         }
     }
     const size_t increased_bytes = frame->header.blocksize * frame->header.channels * bytewidth;
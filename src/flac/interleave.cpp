@@ -0,0 +1,129 @@
+#include <cstring>
+
+#include "interleave.hpp"
+
+#if defined(__SSE2__)
+#define SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace interleave {
+namespace {
+template <size_t width>
+inline void store(int32_t value, uint8_t* dst) {
+    const auto u = static_cast<uint32_t>(value);
+    if constexpr(width == 1) {
+        dst[0] = u;
+    } else if constexpr(width == 2) {
+        const auto v = static_cast<uint16_t>(u);
+        std::memcpy(dst, &v, 2);
+    } else if constexpr(width == 3) {
+        dst[0] = u;
+        dst[1] = u >> 8;
+        dst[2] = u >> 16;
+    } else {
+        std::memcpy(dst, &u, 4);
+    }
+}
+
+template <size_t width>
+void generic(const int32_t* const planes[], size_t channels, size_t frames, uint8_t* dst, size_t from) {
+    const size_t stride = channels * width;
+    for(size_t c = 0; c < channels; ++c) {
+        const int32_t* src = planes[c];
+        uint8_t*       d   = dst + from * stride + c * width;
+        for(size_t b = from; b < frames; b += 1, d += stride) {
+            store<width>(src[b], d);
+        }
+    }
+}
+
+template <size_t width>
+void stereo(const int32_t* const planes[], size_t frames, uint8_t* dst, size_t from) {
+    const int32_t* l = planes[0];
+    const int32_t* r = planes[1];
+    for(size_t b = from; b < frames; b += 1) {
+        store<width>(l[b], &dst[b * width * 2]);
+        store<width>(r[b], &dst[b * width * 2 + width]);
+    }
+}
+
+#ifdef SIMD_SSE2
+// decoded samples already fit in the low bytes, so signed saturation never kicks in
+// and packing is the same as truncating.
+size_t sse2_mono16(const int32_t* src, size_t frames, uint8_t* dst) {
+    size_t b = 0;
+    for(; b + 8 <= frames; b += 8) {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[b]));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[b + 4]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[b * 2]), _mm_packs_epi32(lo, hi));
+    }
+    return b;
+}
+size_t sse2_stereo16(const int32_t* l, const int32_t* r, size_t frames, uint8_t* dst) {
+    size_t b = 0;
+    for(; b + 8 <= frames; b += 8) {
+        const __m128i left  = _mm_packs_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&l[b])),
+                                              _mm_loadu_si128(reinterpret_cast<const __m128i*>(&l[b + 4])));
+        const __m128i right = _mm_packs_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&r[b])),
+                                              _mm_loadu_si128(reinterpret_cast<const __m128i*>(&r[b + 4])));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[b * 4]), _mm_unpacklo_epi16(left, right));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[b * 4 + 16]), _mm_unpackhi_epi16(left, right));
+    }
+    return b;
+}
+size_t sse2_stereo32(const int32_t* l, const int32_t* r, size_t frames, uint8_t* dst) {
+    size_t b = 0;
+    for(; b + 4 <= frames; b += 4) {
+        const __m128i left  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&l[b]));
+        const __m128i right = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&r[b]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[b * 8]), _mm_unpacklo_epi32(left, right));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[b * 8 + 16]), _mm_unpackhi_epi32(left, right));
+    }
+    return b;
+}
+#endif
+
+template <size_t width>
+void kernel(const int32_t* const planes[], size_t channels, size_t frames, uint8_t* dst) {
+    if(channels == 1) {
+        size_t from = 0;
+        if constexpr(width == 4) {
+            std::memcpy(dst, planes[0], frames * 4);
+            return;
+        }
+#ifdef SIMD_SSE2
+        if constexpr(width == 2) {
+            from = sse2_mono16(planes[0], frames, dst);
+        }
+#endif
+        generic<width>(planes, 1, frames, dst, from);
+    } else if(channels == 2) {
+        size_t from = 0;
+#ifdef SIMD_SSE2
+        if constexpr(width == 2) {
+            from = sse2_stereo16(planes[0], planes[1], frames, dst);
+        } else if constexpr(width == 4) {
+            from = sse2_stereo32(planes[0], planes[1], frames, dst);
+        }
+#endif
+        stereo<width>(planes, frames, dst, from);
+    } else {
+        generic<width>(planes, channels, frames, dst, 0);
+    }
+}
+
+constexpr InterleaveFunc kernels[] = {kernel<1>, kernel<2>, kernel<3>, kernel<4>};
+} // namespace
+
+InterleaveFunc get_kernel(size_t bytewidth) {
+    return kernels[bytewidth - 1];
+}
+const char* get_simd_instruction_set() {
+#ifdef SIMD_SSE2
+    return "sse2";
+#else
+    return "none";
+#endif
+}
+} // namespace interleave
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace interleave {
+// packs frames samples of each of the channels planes into dst as interleaved
+// little endian samples of bytewidth bytes, keeping the low bytes of each sample.
+// dst must have room for frames * channels * bytewidth bytes.
+using InterleaveFunc = void (*)(const int32_t* const planes[], size_t channels, size_t frames, uint8_t* dst);
+
+// returns the kernel for bytewidth, which must be in [1, 4].
+InterleaveFunc get_kernel(size_t bytewidth);
+
+// the name of the instruction set the kernels use.
+const char* get_simd_instruction_set();
+} // namespace interleave
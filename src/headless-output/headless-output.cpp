@@ -0,0 +1,4 @@
+#include "headless-output.hpp"
+
+BOXTEN_MODULE({"Null output", boxten::COMPONENT_TYPE::STREAM_OUTPUT, CATALOGUE_CALLBACK(NullOutput)},
+              {"WAV file output", boxten::COMPONENT_TYPE::STREAM_OUTPUT, CATALOGUE_CALLBACK(WavOutput)})
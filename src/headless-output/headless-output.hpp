@@ -0,0 +1,6 @@
+#pragma once
+#include <libboxten.hpp>
+
+#include "null-output.hpp"
+#include "wav-output.hpp"
+#include <config.h>
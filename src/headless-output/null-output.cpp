@@ -0,0 +1,9 @@
+#include "null-output.hpp"
+
+bool NullOutput::consume(const boxten::PCMPacketUnit& /* packet */) {
+    return true;
+}
+NullOutput::NullOutput(void* param) : Sink(param, "null output") {}
+NullOutput::~NullOutput() {
+    exit_consumer();
+}
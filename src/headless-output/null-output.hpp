@@ -0,0 +1,12 @@
+#pragma once
+#include "sink.hpp"
+
+// drops every packet. measures how fast the sound processors alone can go.
+class NullOutput : public Sink {
+  protected:
+    bool consume(const boxten::PCMPacketUnit& packet) override;
+
+  public:
+    NullOutput(void* param);
+    ~NullOutput() override;
+};
@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+#include "playback.hpp"
+#include "sink.hpp"
+
+namespace {
+u64 nanoseconds_between(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+} // namespace
+
+double Sink::Stats::realtime_factor() const {
+    return wall_nanoseconds != 0 ? static_cast<double>(audio_nanoseconds) / wall_nanoseconds : 0;
+}
+bool Sink::open_sink(const boxten::PCMFormat& /* format */) {
+    return true;
+}
+void Sink::close_sink() {}
+void Sink::consumer_main() {
+    // pacing starts over after every pause
+    auto origin             = std::chrono::steady_clock::now();
+    u64  audio_since_origin = 0;
+    u64  wall_at_origin     = 0;
+    u64  idle               = 0; // time the sound processors had nothing to give, not counted as playing
+    while(!finish_consumer) {
+        {
+            std::unique_lock<std::mutex> lock(pause_lock);
+            if(paused) {
+                wall_at_origin += nanoseconds_between(origin, std::chrono::steady_clock::now());
+                pause_changed.wait(lock, [this]() { return !paused || finish_consumer; });
+                origin             = std::chrono::steady_clock::now();
+                audio_since_origin = 0;
+                continue;
+            }
+        }
+        const auto fetch_start = std::chrono::steady_clock::now();
+        auto       packets     = get_buffer_pcm_packet(boxten::PCMPACKET_PERIOD);
+        const auto fetch_ns    = nanoseconds_between(fetch_start, std::chrono::steady_clock::now());
+        if(packets.empty()) {
+            // nothing buffered, do not spin on the sound processors
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            idle += nanoseconds_between(fetch_start, std::chrono::steady_clock::now());
+            continue;
+        }
+
+        Stats delta;
+        for(auto& p : packets) {
+            const auto consume_start = std::chrono::steady_clock::now();
+            if(!consume(p)) {
+                console.error << name << ": cannot consume packets, stopping playback." << std::endl;
+                boxten::stop_playback();
+                return;
+            }
+            const auto consume_ns = nanoseconds_between(consume_start, std::chrono::steady_clock::now());
+            delta.packets += 1;
+            delta.frames += p.get_frames();
+            delta.audio_nanoseconds += p.format.sampling_rate != 0 ? p.get_frames() * 1000000000 / p.format.sampling_rate : 0;
+            delta.consume_nanoseconds += consume_ns;
+            delta.min_consume_nanoseconds = std::min(delta.min_consume_nanoseconds, consume_ns);
+            delta.max_consume_nanoseconds = std::max(delta.max_consume_nanoseconds, consume_ns);
+        }
+        audio_since_origin += delta.audio_nanoseconds;
+        if(paced) {
+            std::this_thread::sleep_until(origin + std::chrono::nanoseconds(audio_since_origin));
+        }
+        {
+            std::lock_guard<std::mutex> lock(stats.lock);
+            auto&                       data = stats.data;
+            data.packets += delta.packets;
+            data.frames += delta.frames;
+            data.audio_nanoseconds += delta.audio_nanoseconds;
+            data.wall_nanoseconds = wall_at_origin + nanoseconds_between(origin, std::chrono::steady_clock::now()) - idle;
+            data.fetches += 1;
+            data.fetch_nanoseconds += fetch_ns;
+            data.min_fetch_nanoseconds = std::min(data.min_fetch_nanoseconds, fetch_ns);
+            data.max_fetch_nanoseconds = std::max(data.max_fetch_nanoseconds, fetch_ns);
+            data.consume_nanoseconds += delta.consume_nanoseconds;
+            data.min_consume_nanoseconds = std::min(data.min_consume_nanoseconds, delta.min_consume_nanoseconds);
+            data.max_consume_nanoseconds = std::max(data.max_consume_nanoseconds, delta.max_consume_nanoseconds);
+        }
+    }
+}
+void Sink::exit_consumer() {
+    {
+        std::lock_guard<std::mutex> lock(pause_lock);
+        finish_consumer = true;
+    }
+    pause_changed.notify_all();
+    if(!consumer) return;
+    if(consumer.get_id() == std::this_thread::get_id()) {
+        // consume() failed and the consumer stops playback itself, it exits after returning here
+        consumer.detach();
+    } else {
+        consumer.join();
+    }
+}
+Sink::Stats Sink::get_stats() {
+    std::lock_guard<std::mutex> lock(stats.lock);
+    return stats.data;
+}
+void Sink::dump_stats() {
+    const auto data = get_stats();
+    console.message << name << ": " << data.packets << " packets, " << data.frames << " frames, "
+                    << data.audio_nanoseconds / 1000000.0 << " ms of audio in " << data.wall_nanoseconds / 1000000.0 << " ms, "
+                    << "realtime factor " << data.realtime_factor() << "." << std::endl;
+    if(data.fetches != 0) {
+        console.message << "fetch: min " << data.min_fetch_nanoseconds / 1000.0 << " us, avg " << data.fetch_nanoseconds / data.fetches / 1000.0
+                        << " us, max " << data.max_fetch_nanoseconds / 1000.0 << " us." << std::endl;
+    }
+    if(data.packets != 0) {
+        console.message << "consume: min " << data.min_consume_nanoseconds / 1000.0 << " us, avg " << data.consume_nanoseconds / data.packets / 1000.0
+                        << " us, max " << data.max_consume_nanoseconds / 1000.0 << " us per packet." << std::endl;
+    }
+}
+boxten::n_frames Sink::output_delay() {
+    // packets are gone as soon as they are consumed
+    return 0;
+}
+void Sink::start_playback() {
+    if(consumer) return;
+    if(!open_sink(get_buffer_pcm_format())) {
+        console.error << name << ": failed to open." << std::endl;
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(stats.lock);
+        stats.data = Stats();
+    }
+    paused          = false;
+    finish_consumer = false;
+    consumer        = boxten::Worker(std::bind(&Sink::consumer_main, this));
+}
+void Sink::stop_playback() {
+    exit_consumer();
+    close_sink();
+    dump_stats();
+}
+void Sink::pause_playback() {
+    {
+        std::lock_guard<std::mutex> lock(pause_lock);
+        paused = true;
+    }
+    pause_changed.notify_all();
+}
+void Sink::resume_playback() {
+    {
+        std::lock_guard<std::mutex> lock(pause_lock);
+        paused = false;
+    }
+    pause_changed.notify_all();
+}
+Sink::Sink(void* param, const char* name) : boxten::StreamOutput(param), name(name) {
+    if(i64 realtime; get_number("realtime", realtime)) {
+        paced = realtime != 0;
+    }
+}
+Sink::~Sink() {
+    set_number("realtime", paced);
+}
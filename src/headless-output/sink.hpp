@@ -0,0 +1,68 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+#include <libboxten.hpp>
+
+#include <config.h>
+
+// an output without a device. a thread pulls packets from the sound processors as
+// fast as they come, or at playback speed if "realtime" is set, and hands them to
+// consume(). the timings tell how fast decoding and processing run on their own.
+class Sink : public boxten::StreamOutput {
+  public:
+    struct Stats {
+        u64 packets           = 0;
+        u64 frames            = 0;
+        u64 audio_nanoseconds = 0; // playback duration of the consumed frames
+        u64 wall_nanoseconds  = 0; // time spent playing, pauses and waits for data excluded
+
+        // per call of get_buffer_pcm_packet that returned packets
+        u64 fetches               = 0;
+        u64 fetch_nanoseconds     = 0;
+        u64 min_fetch_nanoseconds = UINT64_MAX;
+        u64 max_fetch_nanoseconds = 0;
+
+        // per packet
+        u64 consume_nanoseconds     = 0;
+        u64 min_consume_nanoseconds = UINT64_MAX;
+        u64 max_consume_nanoseconds = 0;
+
+        // seconds of audio produced per second of wall time
+        double realtime_factor() const;
+    };
+
+  private:
+    const char*             name;
+    boxten::Worker          consumer;
+    std::atomic<bool>       finish_consumer = false;
+    std::mutex              pause_lock;
+    std::condition_variable pause_changed;
+    bool                    paused = false;
+    bool                    paced  = false;
+    boxten::SafeVar<Stats>  stats  = Stats();
+
+    void consumer_main();
+
+  protected:
+    // called on start_playback, before the consumer runs. returns false to abort playback.
+    virtual bool open_sink(const boxten::PCMFormat& format);
+    // called from the consumer thread for every packet. returns false to stop playback.
+    virtual bool consume(const boxten::PCMPacketUnit& packet) = 0;
+    // called on stop_playback, after the consumer exited.
+    virtual void close_sink();
+    // subclasses call this from their destructor, consume() must not run after it.
+    void exit_consumer();
+
+  public:
+    Stats            get_stats();
+    void             dump_stats(); // writes the stats to the console
+    boxten::n_frames output_delay() override;
+    void             start_playback() override;
+    void             stop_playback() override;
+    void             pause_playback() override;
+    void             resume_playback() override;
+    Sink(void* param, const char* name);
+    ~Sink() override;
+};
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+
+#include <json.hpp>
+#include <jsontest.hpp>
+
+#include "configuration.hpp"
+#include "format-negotiation.hpp"
+#include "wav-output.hpp"
+
+namespace {
+// sample types a plain wave format chunk can describe
+const negotiation::DeviceFormats wav_formats = {
+    {boxten::SampleType::u8, boxten::SampleType::s16_le, boxten::SampleType::s24_le, boxten::SampleType::s32_le, boxten::SampleType::f32_le},
+    {},
+    {},
+};
+
+constexpr u16 format_pcm        = 1;
+constexpr u16 format_float      = 3;
+constexpr u16 format_extensible = 0xFFFE;
+
+// KSDATAFORMAT_SUBTYPE_PCM and _IEEE_FLOAT after their leading format tag
+constexpr u8 subformat_tail[14] = {0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71};
+
+constexpr size_t max_header_size = 80;
+
+// plain pcm format chunks are only read reliably for up to 16 bits and 2 channels,
+// everything else, and float which also needs a fact chunk, goes in WAVE_FORMAT_EXTENSIBLE
+bool is_float(const boxten::PCMFormat& format) {
+    return format.sample_type == boxten::SampleType::f32_le;
+}
+bool is_extensible(const boxten::PCMFormat& format) {
+    return is_float(format) || format.get_sample_bytewidth() > 2 || format.channels > 2;
+}
+size_t header_size(const boxten::PCMFormat& format) {
+    return 12 + 8 + (is_extensible(format) ? 40 : 16) + (is_float(format) ? 12 : 0) + 8;
+}
+// speaker positions in the channel order of wav and flac
+u32 channel_mask(u32 channels) {
+    constexpr u32 masks[] = {0, 0x4, 0x3, 0x7, 0x33, 0x37, 0x3F, 0x70F, 0x63F};
+    return channels < std::size(masks) ? masks[channels] : 0;
+}
+
+template <typename T>
+u8* put(u8* dst, T value) {
+    for(size_t b = 0; b < sizeof(T); ++b) {
+        dst[b] = static_cast<u8>(static_cast<u64>(value) >> (b * 8));
+    }
+    return dst + sizeof(T);
+}
+u8* put_id(u8* dst, const char (&id)[5]) {
+    std::copy(id, id + 4, dst);
+    return dst + 4;
+}
+} // namespace
+
+// the sizes are only known at the end, so the header is written once with zeros and again on close
+bool WavOutput::write_header() {
+    const auto size        = header_size(format);
+    const u32  data_size   = std::min<u64>(data_bytes, UINT32_MAX - size);
+    const u16  bytewidth   = format.get_sample_bytewidth();
+    const u16  block_align = bytewidth * format.channels;
+    const u16  tag         = is_float(format) ? format_float : format_pcm;
+    u8         header[max_header_size];
+    u8*        p = header;
+    p            = put_id(p, "RIFF");
+    p            = put(p, static_cast<u32>(size - 8 + data_size + data_size % 2));
+    p            = put_id(p, "WAVE");
+    p            = put_id(p, "fmt ");
+    p            = put(p, static_cast<u32>(is_extensible(format) ? 40 : 16));
+    p            = put(p, is_extensible(format) ? format_extensible : tag);
+    p            = put(p, static_cast<u16>(format.channels));
+    p            = put(p, static_cast<u32>(format.sampling_rate));
+    p            = put(p, static_cast<u32>(format.sampling_rate * block_align));
+    p            = put(p, block_align);
+    p            = put(p, static_cast<u16>(bytewidth * 8));
+    if(is_extensible(format)) {
+        p = put(p, static_cast<u16>(22));
+        p = put(p, static_cast<u16>(bytewidth * 8)); // valid bits, the samples fill their container
+        p = put(p, channel_mask(format.channels));
+        p = put(p, tag);
+        p = std::copy(std::begin(subformat_tail), std::end(subformat_tail), p);
+    }
+    if(is_float(format)) {
+        p = put_id(p, "fact");
+        p = put(p, static_cast<u32>(4));
+        p = put(p, static_cast<u32>(data_size / block_align));
+    }
+    p = put_id(p, "data");
+    p = put(p, data_size);
+    file.seekp(0);
+    file.write(reinterpret_cast<char*>(header), p - header);
+    file.seekp(0, std::ios::end);
+    return static_cast<bool>(file);
+}
+bool WavOutput::open_sink(const boxten::PCMFormat& format) {
+    if(path.empty()) {
+        console.error << "WAV file output: \"path\" is not set." << std::endl;
+        return false;
+    }
+    if(!wav_formats.accepts(format.sample_type) || format.channels == 0) {
+        console.error << "WAV file output: the sound processors did not convert to a format wav can store." << std::endl;
+        return false;
+    }
+    file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!file) {
+        console.error << "WAV file output: cannot open " << path << "." << std::endl;
+        return false;
+    }
+    this->format      = format;
+    data_bytes        = 0;
+    mismatch_reported = false;
+    // keep the file at one format, whatever the next tracks are
+    negotiation::publish({{format.sample_type}, {format.sampling_rate}, {format.channels}});
+    return write_header();
+}
+bool WavOutput::consume(const boxten::PCMPacketUnit& packet) {
+    if(packet.format != format) {
+        if(!mismatch_reported) {
+            console.error << "WAV file output: the sound processors did not convert to the format of the file, packets are dropped." << std::endl;
+            mismatch_reported = true;
+        }
+        return true;
+    }
+    file.write(reinterpret_cast<const char*>(packet.pcm.data()), packet.pcm.size());
+    data_bytes += packet.pcm.size();
+    return static_cast<bool>(file);
+}
+void WavOutput::close_sink() {
+    if(!file.is_open()) return;
+    if(data_bytes > UINT32_MAX - header_size(format)) {
+        console.error << "WAV file output: more than 4 GiB written, the header of " << path << " is truncated." << std::endl;
+    }
+    // riff chunks are word aligned, the pad byte is not part of the data size
+    if(data_bytes % 2 != 0) {
+        file.put(0);
+    }
+    if(!write_header()) {
+        console.error << "WAV file output: cannot finish " << path << "." << std::endl;
+    }
+    file.close();
+    negotiation::publish(wav_formats);
+}
+WavOutput::WavOutput(void* param) : Sink(param, "WAV file output") {
+    if(nlohmann::json conf; load_configuration(conf) && boxten::type_check("path", boxten::JSON_TYPE::STRING, conf)) {
+        path = conf["path"].get<std::string>();
+    }
+    negotiation::publish(wav_formats);
+}
+WavOutput::~WavOutput() {
+    exit_consumer();
+    close_sink();
+    negotiation::withdraw();
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <fstream>
+#include <string>
+
+#include "sink.hpp"
+
+// writes the packets to the wav file given by "path".
+// the file keeps the format of the first packet, the sound processors are asked to
+// convert later ones to it.
+class WavOutput : public Sink {
+  private:
+    std::string       path;
+    std::ofstream     file;
+    boxten::PCMFormat format;
+    u64               data_bytes = 0;
+    bool              mismatch_reported = false;
+
+    bool write_header();
+
+  protected:
+    bool open_sink(const boxten::PCMFormat& format) override;
+    bool consume(const boxten::PCMPacketUnit& packet) override;
+    void close_sink() override;
+
+  public:
+    WavOutput(void* param);
+    ~WavOutput() override;
+};
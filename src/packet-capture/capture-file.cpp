@@ -0,0 +1,103 @@
+#include <cstring>
+
+#include "capture-file.hpp"
+
+namespace capture {
+namespace {
+constexpr size_t packet_header_size = 8 + 4 * 3 + 8 * 2 + 8;
+
+// u32_be is the last sample type, as in pcm-format
+constexpr u32 n_sample_types = static_cast<u32>(boxten::SampleType::u32_be) + 1;
+
+template <typename T>
+u8* put(u8* dst, T value) {
+    for(size_t b = 0; b < sizeof(T); ++b) {
+        dst[b] = static_cast<u8>(static_cast<u64>(value) >> (b * 8));
+    }
+    return dst + sizeof(T);
+}
+template <typename T>
+const u8* get(const u8* src, T& value) {
+    u64 v = 0;
+    for(size_t b = 0; b < sizeof(T); ++b) {
+        v |= static_cast<u64>(src[b]) << (b * 8);
+    }
+    value = static_cast<T>(v);
+    return src + sizeof(T);
+}
+} // namespace
+
+bool Writer::open(const char* path) {
+    file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!file) return false;
+    u8 header[sizeof(magic) + 4];
+    std::memcpy(header, magic, sizeof(magic));
+    put(header + sizeof(magic), version);
+    file.write(reinterpret_cast<char*>(header), sizeof(header));
+    start = std::chrono::steady_clock::now();
+    return static_cast<bool>(file);
+}
+bool Writer::write(const boxten::PCMPacketUnit& packet) {
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    u8         header[packet_header_size];
+    u8*        p = header;
+    p            = put(p, static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    p            = put(p, static_cast<u32>(packet.format.sample_type));
+    p            = put(p, static_cast<u32>(packet.format.channels));
+    p            = put(p, static_cast<u32>(packet.format.sampling_rate));
+    p            = put(p, static_cast<u64>(packet.original_frame_pos[0]));
+    p            = put(p, static_cast<u64>(packet.original_frame_pos[1]));
+    p            = put(p, static_cast<u64>(packet.pcm.size()));
+    file.write(reinterpret_cast<char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(packet.pcm.data()), packet.pcm.size());
+    return static_cast<bool>(file);
+}
+bool Writer::is_open() const {
+    return file.is_open();
+}
+
+bool Reader::open(const char* path) {
+    file.open(path, std::ios::in | std::ios::binary | std::ios::ate);
+    length = static_cast<u64>(file.tellg());
+    file.seekg(0);
+    u8 header[sizeof(magic) + 4];
+    if(!file.read(reinterpret_cast<char*>(header), sizeof(header))) return false;
+    u32 file_version;
+    get(header + sizeof(magic), file_version);
+    return std::memcmp(header, magic, sizeof(magic)) == 0 && file_version == version;
+}
+ReadResult Reader::read(Packet& packet) {
+    u8 header[packet_header_size];
+    if(!file.read(reinterpret_cast<char*>(header), sizeof(header))) {
+        return file.gcount() == 0 ? ReadResult::end : ReadResult::corrupt;
+    }
+    const u8* p = header;
+    u32       sample_type, channels, sampling_rate;
+    u64       pos[2], size;
+    p = get(p, packet.timestamp);
+    p = get(p, sample_type);
+    p = get(p, channels);
+    p = get(p, sampling_rate);
+    p = get(p, pos[0]);
+    p = get(p, pos[1]);
+    p = get(p, size);
+
+    // the header comes from the file, nothing in it may make the packet unusable:
+    // the payload must fit in what is left of the file and hold whole frames
+    if(sample_type >= n_sample_types || sample_type == static_cast<u32>(boxten::SampleType::unknown) || channels == 0 || sampling_rate == 0) {
+        return ReadResult::corrupt;
+    }
+    auto& unit                 = packet.unit;
+    unit.format.sample_type    = static_cast<boxten::SampleType>(sample_type);
+    unit.format.channels       = channels;
+    unit.format.sampling_rate  = sampling_rate;
+    unit.original_frame_pos[0] = pos[0];
+    unit.original_frame_pos[1] = pos[1];
+    const u64 frame_bytes      = static_cast<u64>(unit.format.get_sample_bytewidth()) * channels;
+    if(const auto position = static_cast<u64>(file.tellg()); size > length - position || frame_bytes == 0 || size % frame_bytes != 0) {
+        return ReadResult::corrupt;
+    }
+    unit.pcm.resize(size);
+    return file.read(reinterpret_cast<char*>(unit.pcm.data()), size) ? ReadResult::packet : ReadResult::corrupt;
+}
+} // namespace capture
@@ -0,0 +1,50 @@
+#pragma once
+#include <chrono>
+#include <fstream>
+
+#include <libboxten.hpp>
+
+// a compact binary record of the packets passing a point of the pipeline.
+// every integer is little endian.
+//   header : "BXPC", u32 version
+//   packet : u64 timestamp in ns since the capture began,
+//            u32 sample type, u32 channels, u32 sampling rate,
+//            u64 original frame position x 2, u64 payload bytes, payload
+namespace capture {
+constexpr char magic[4] = {'B', 'X', 'P', 'C'};
+constexpr u32  version  = 1;
+
+struct Packet {
+    u64                   timestamp;
+    boxten::PCMPacketUnit unit;
+};
+
+class Writer {
+  private:
+    std::ofstream                         file;
+    std::chrono::steady_clock::time_point start;
+
+  public:
+    // truncates path
+    bool open(const char* path);
+    bool write(const boxten::PCMPacketUnit& packet);
+    bool is_open() const;
+};
+
+enum class ReadResult {
+    packet,
+    end,
+    corrupt, // truncated, or a header no packet can have
+};
+
+class Reader {
+  private:
+    std::ifstream file;
+    u64           length = 0; // of the whole file
+
+  public:
+    // fails if path is not a capture of a supported version
+    bool open(const char* path);
+    ReadResult read(Packet& packet);
+};
+} // namespace capture
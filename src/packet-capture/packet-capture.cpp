@@ -0,0 +1,29 @@
+#include <string>
+
+#include <json.hpp>
+#include <jsontest.hpp>
+
+#include "packet-capture.hpp"
+#include "configuration.hpp"
+#include "plugin.hpp"
+
+bool PacketCapture::modify_packet(boxten::PCMPacketUnit& packet) {
+    if(writer.is_open() && !writer.write(packet)) {
+        console.error << "packet capture: write failed, capture stopped." << std::endl;
+        writer = capture::Writer();
+    }
+    return true;
+}
+PacketCapture::PacketCapture(void* param) : boxten::SoundProcessor(param) {
+    nlohmann::json conf;
+    if(!load_configuration(conf) || !boxten::type_check("path", boxten::JSON_TYPE::STRING, conf)) {
+        console.error << "packet capture: \"path\" is not set, nothing will be captured." << std::endl;
+        return;
+    }
+    const auto path = conf["path"].get<std::string>();
+    if(!writer.open(path.data())) {
+        console.error << "packet capture: cannot open " << path << "." << std::endl;
+    }
+}
+
+BOXTEN_MODULE({"packet capture", boxten::COMPONENT_TYPE::SOUND_PROCESSOR, CATALOGUE_CALLBACK(PacketCapture)})
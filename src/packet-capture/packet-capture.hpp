@@ -0,0 +1,17 @@
+#pragma once
+#include "capture-file.hpp"
+#include "plugin.hpp"
+#include <libboxten.hpp>
+
+#include <config.h>
+
+// records every packet passing it to the file given by "path", unchanged.
+// put it before or after another processor to capture what that processor sees.
+class PacketCapture : public boxten::SoundProcessor {
+  private:
+    capture::Writer writer;
+
+  public:
+    bool modify_packet(boxten::PCMPacketUnit& packet) override;
+    PacketCapture(void* param);
+};
@@ -0,0 +1,240 @@
+// feeds a packet capture through sound processors as fast as possible and reports the throughput.
+// usage: packet-replay CAPTURE [STEP...] [-t TYPES] [-r RATES] [-c CHANNELS] [-o OUTPUT] [-n REPEAT]
+// steps run the processing of the modules themselves, in the given order:
+//   format[:OPTIONS]   the packet format module. options: to=TYPE, dither=0|1, channels=N,
+//                      threads=N, threshold=N. TYPE is a name like s16le or f32le
+//   resample[:OPTIONS] the resampler module. options: rate=N, quality=N
+// OPTIONS is a comma separated list of KEY=VALUE.
+// -t, -r and -c publish comma separated sample types, rates and channel counts as the output
+// device formats, which the processors negotiate with like they do with an output module.
+// the packets leaving the last step are written to OUTPUT if given.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "capture-file.hpp"
+#include "convert.hpp"
+#include "format-negotiation.hpp"
+#include "packet-formatter.hpp"
+#include "packet-resampler.hpp"
+
+namespace {
+class Step {
+  public:
+    std::string name;
+    u64         nanoseconds = 0;
+
+    virtual bool process(boxten::PCMPacketUnit& packet) = 0;
+    Step(std::string name) : name(std::move(name)) {}
+    virtual ~Step() {}
+};
+
+template <typename Processor>
+class ProcessorStep : public Step {
+  private:
+    Processor processor;
+
+  public:
+    bool process(boxten::PCMPacketUnit& packet) override {
+        return processor.modify_packet(packet);
+    }
+    ProcessorStep(std::string name, typename Processor::Options options)
+        : Step(std::move(name)),
+          processor(std::move(options), [this](const std::string& message) {
+              std::fprintf(stderr, "%s: %s\n", this->name.data(), message.data());
+          }) {}
+};
+
+boxten::SampleType parse_sample_type(const std::string& name) {
+    for(size_t i = 1; i < convert::n_sample_types; ++i) {
+        if(name == convert::sample_info_table[i].name) {
+            return static_cast<boxten::SampleType>(i);
+        }
+    }
+    return boxten::SampleType::unknown;
+}
+
+// calls callback with each item of a separated list. stops and returns false when callback fails.
+bool for_each_item(const std::string& list, char separator, const std::function<bool(const std::string&)>& callback) {
+    for(size_t begin = 0; begin <= list.size();) {
+        const auto end = std::min(list.find(separator, begin), list.size());
+        if(!callback(list.substr(begin, end - begin))) return false;
+        begin = end + 1;
+    }
+    return true;
+}
+
+// calls callback with each KEY=VALUE of options
+bool for_each_option(const std::string& options, const std::function<bool(const std::string&, const std::string&)>& callback) {
+    if(options.empty()) return true;
+    return for_each_item(options, ',', [&callback](const std::string& option) {
+        const auto equal = option.find('=');
+        return equal != std::string::npos && callback(option.substr(0, equal), option.substr(equal + 1));
+    });
+}
+
+std::unique_ptr<Step> parse_step(const std::string& spec) {
+    const auto colon   = spec.find(':');
+    const auto kind    = spec.substr(0, colon);
+    const auto options = colon == std::string::npos ? std::string() : spec.substr(colon + 1);
+    if(kind == "format") {
+        PacketFormatter::Options format;
+        const auto               ok = for_each_option(options, [&format](const std::string& key, const std::string& value) {
+            const auto number = std::atoi(value.data());
+            if(key == "to") {
+                format.to = parse_sample_type(value);
+                return format.to != boxten::SampleType::unknown;
+            } else if(key == "dither") {
+                format.dither = number != 0;
+            } else if(key == "channels" && number > 0 && static_cast<size_t>(number) <= channel::max_channels) {
+                format.channels = number;
+            } else if(key == "threads" && number >= 0) {
+                format.worker_threads = number;
+            } else if(key == "threshold" && number > 0) {
+                format.parallel_threshold = number;
+            } else {
+                return false;
+            }
+            return true;
+        });
+        if(ok) {
+            return std::make_unique<ProcessorStep<PacketFormatter>>(spec, std::move(format));
+        }
+    } else if(kind == "resample") {
+        resample::PacketResampler::Options resampling;
+        const auto                         ok = for_each_option(options, [&resampling](const std::string& key, const std::string& value) {
+            const auto number = std::atoi(value.data());
+            if(key == "rate" && number > 0) {
+                resampling.rate = number;
+            } else if(key == "quality" && number >= 0 && static_cast<size_t>(number) < resample::n_qualities) {
+                resampling.quality = number;
+            } else {
+                return false;
+            }
+            return true;
+        });
+        if(ok) {
+            return std::make_unique<ProcessorStep<resample::PacketResampler>>(spec, resampling);
+        }
+    }
+    return nullptr;
+}
+
+int usage(const char* argv0) {
+    std::fprintf(stderr, "usage: %s CAPTURE [format[:OPTIONS] | resample[:OPTIONS]]... [-t TYPES] [-r RATES] [-c CHANNELS] [-o OUTPUT] [-n REPEAT]\n", argv0);
+    return 1;
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if(argc < 2) return usage(argv[0]);
+
+    const char*                        output = nullptr;
+    size_t                             repeat = 1;
+    std::vector<std::unique_ptr<Step>> steps;
+    negotiation::DeviceFormats         device_formats;
+    for(int i = 2; i < argc; ++i) {
+        if(std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else if(std::strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            repeat = std::max(1, std::atoi(argv[++i]));
+        } else if(std::strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            const auto ok = for_each_item(argv[++i], ',', [&device_formats](const std::string& name) {
+                const auto type = parse_sample_type(name);
+                device_formats.sample_types.emplace_back(type);
+                return type != boxten::SampleType::unknown;
+            });
+            if(!ok) {
+                std::fprintf(stderr, "unknown sample type in %s\n", argv[i]);
+                return usage(argv[0]);
+            }
+        } else if(std::strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            for_each_item(argv[++i], ',', [&device_formats](const std::string& rate) {
+                device_formats.sampling_rates.emplace_back(std::atoi(rate.data()));
+                return true;
+            });
+        } else if(std::strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            for_each_item(argv[++i], ',', [&device_formats](const std::string& channels) {
+                device_formats.channel_counts.emplace_back(std::atoi(channels.data()));
+                return true;
+            });
+        } else if(auto step = parse_step(argv[i]); step) {
+            steps.emplace_back(std::move(step));
+        } else {
+            std::fprintf(stderr, "unknown step %s\n", argv[i]);
+            return usage(argv[0]);
+        }
+    }
+
+    if(!device_formats.sample_types.empty() || !device_formats.sampling_rates.empty() || !device_formats.channel_counts.empty()) {
+        negotiation::publish(std::move(device_formats));
+    }
+
+    // load everything first, so that the file system does not take part in the measurement
+    capture::Reader reader;
+    if(!reader.open(argv[1])) {
+        std::fprintf(stderr, "%s is not a packet capture\n", argv[1]);
+        return 1;
+    }
+    std::vector<capture::Packet> packets;
+    auto                         result = capture::ReadResult::packet;
+    for(capture::Packet packet; (result = reader.read(packet)) == capture::ReadResult::packet;) {
+        packets.emplace_back(std::move(packet));
+    }
+    if(result == capture::ReadResult::corrupt) {
+        std::fprintf(stderr, "%s is corrupt after %zu packets\n", argv[1], packets.size());
+        return 1;
+    }
+
+    capture::Writer writer;
+    if(output != nullptr && !writer.open(output)) {
+        std::fprintf(stderr, "cannot open %s\n", output);
+        return 1;
+    }
+
+    u64    frames       = 0;
+    double audio_length = 0;
+    size_t failures     = 0;
+    u64    total        = 0;
+    for(size_t r = 0; r < repeat; ++r) {
+        for(const auto& captured : packets) {
+            auto packet = captured.unit;
+            frames += packet.get_frames();
+            audio_length += static_cast<double>(packet.get_frames()) / packet.format.sampling_rate;
+            for(auto& step : steps) {
+                const auto start = std::chrono::steady_clock::now();
+                const auto ok    = step->process(packet);
+                const auto end   = std::chrono::steady_clock::now();
+                const auto ns    = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+                step->nanoseconds += ns;
+                total += ns;
+                if(!ok) {
+                    failures += 1;
+                    break;
+                }
+            }
+            if(r == 0 && writer.is_open()) {
+                writer.write(packet);
+            }
+        }
+    }
+
+    std::printf("%zu packets, %llu frames, %.1f s of audio\n", packets.size() * repeat, static_cast<unsigned long long>(frames), audio_length);
+    std::printf("%-28s %12s %10s\n", "step", "ms", "realtime");
+    for(const auto& step : steps) {
+        const double ms = step->nanoseconds / 1e6;
+        std::printf("%-28s %12.3f %10.1f\n", step->name.data(), ms, audio_length / (ms / 1e3));
+    }
+    std::printf("%-28s %12.3f %10.1f\n", "total", total / 1e6, audio_length / (total / 1e9));
+    if(failures != 0) {
+        std::printf("%zu packet(s) could not be processed by a step\n", failures);
+        return 1;
+    }
+    return 0;
+}
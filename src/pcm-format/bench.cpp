@@ -0,0 +1,167 @@
+// microbenchmark and verification for the conversion table.
+// runs every converter over PCMPACKET_PERIOD frames at several channel counts,
+// checks the simd kernels against the generic converters and checks that
+// lossless round trips are bit-exact, and that float -> int conversions saturate.
+// exits with non-zero status if any verification fails.
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "convert.hpp"
+
+namespace {
+constexpr size_t channel_counts[] = {1, 2, 8};
+constexpr size_t min_samples      = 1 << 22; // per measurement
+
+using Info = convert::SampleInfo;
+
+size_t precision(const Info& info) {
+    if(!info.is_float) return info.bits;
+    return info.width == 4 ? 24 : 53;
+}
+
+// random samples valid for the type. floats are kept in [-1.0, 1.0].
+std::vector<u8> make_input(size_t type, size_t n_samples, std::mt19937& engine) {
+    const auto&     info = convert::sample_info_table[type];
+    std::vector<u8> result(n_samples * info.width);
+    if(!info.is_float) {
+        for(auto& b : result) {
+            b = engine();
+        }
+        return result;
+    }
+    std::uniform_real_distribution<f32> dist(-1.0f, 1.0f);
+    std::vector<f32>                    floats(n_samples);
+    for(auto& f : floats) {
+        f = dist(engine);
+    }
+    const auto f32le = static_cast<size_t>(boxten::SampleType::f32_le);
+    if(type == f32le) {
+        std::memcpy(result.data(), floats.data(), result.size());
+    } else {
+        convert::generic_func_table[f32le][type](reinterpret_cast<u8*>(floats.data()), result.data(), n_samples);
+    }
+    return result;
+}
+
+// fills n_samples of a float type with value
+std::vector<u8> make_filled(size_t type, size_t n_samples, f32 value) {
+    const auto       f32le = static_cast<size_t>(boxten::SampleType::f32_le);
+    std::vector<f32> floats(n_samples, value);
+    std::vector<u8>  result(n_samples * 4);
+    if(type == f32le) {
+        std::memcpy(result.data(), floats.data(), result.size());
+    } else {
+        convert::generic_func_table[f32le][type](reinterpret_cast<u8*>(floats.data()), result.data(), n_samples);
+    }
+    return result;
+}
+
+// overshoot must clip to full scale and nan must become silence, in the simd body and the tail alike
+bool check_saturation(size_t from, size_t to, convert::ConvertFunc func) {
+    constexpr size_t n_samples = 67;
+    constexpr f32    inputs[][2] = {
+        {1.5f, 1.0f},
+        {-1.5f, -1.0f},
+        {1e20f, 1.0f},
+        {-1e20f, -1.0f},
+        {INFINITY, 1.0f},
+        {-INFINITY, -1.0f},
+        {NAN, 0.0f},
+    };
+    const auto width = convert::sample_info_table[to].width;
+    for(const auto [input, clipped] : inputs) {
+        auto            src      = make_filled(from, n_samples, input);
+        auto            expected = make_filled(from, n_samples, clipped);
+        std::vector<u8> result(n_samples * width);
+        std::vector<u8> reference(n_samples * width);
+        func(src.data(), result.data(), n_samples);
+        convert::generic_func_table[from][to](expected.data(), reference.data(), n_samples);
+        if(result != reference) {
+            std::printf("FAIL: %s -> %s does not saturate %g\n", convert::sample_info_table[from].name, convert::sample_info_table[to].name, input);
+            return false;
+        }
+    }
+    return true;
+}
+
+struct Result {
+    double ns_per_sample;
+    double gb_per_sec;
+};
+Result measure(convert::ConvertFunc func, std::vector<u8>& src, std::vector<u8>& dst, size_t n_samples) {
+    const size_t iterations = (min_samples + n_samples - 1) / n_samples;
+    func(src.data(), dst.data(), n_samples); // warm up
+    const auto start = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < iterations; ++i) {
+        func(src.data(), dst.data(), n_samples);
+    }
+    const auto   end     = std::chrono::steady_clock::now();
+    const double elapsed = std::chrono::duration<double, std::nano>(end - start).count();
+    const double samples = static_cast<double>(iterations * n_samples);
+    return {elapsed / samples, (src.size() + dst.size()) * iterations / elapsed};
+}
+} // namespace
+
+int main() {
+    std::mt19937 engine(0);
+    size_t       failures = 0;
+
+    std::printf("simd: %s\n", convert::get_simd_instruction_set());
+    std::printf("%-6s -> %-6s %3s %12s %9s\n", "from", "to", "ch", "ns/sample", "GB/s");
+    for(size_t from = 0; from < convert::n_sample_types; ++from) {
+        for(size_t to = 0; to < convert::n_sample_types; ++to) {
+            const auto func = convert::convert_func_table[from][to];
+            if(func == nullptr) continue;
+            const auto& src_info = convert::sample_info_table[from];
+            const auto& dst_info = convert::sample_info_table[to];
+
+            for(auto channels : channel_counts) {
+                const size_t    n_samples = boxten::PCMPACKET_PERIOD * channels;
+                auto            src       = make_input(from, n_samples, engine);
+                std::vector<u8> dst(n_samples * dst_info.width);
+
+                const auto result = measure(func, src, dst, n_samples);
+                std::printf("%-6s -> %-6s %3zu %12.3f %9.3f\n", src_info.name, dst_info.name, channels, result.ns_per_sample, result.gb_per_sec);
+
+                // simd kernels must produce the same output as the generic converter
+                if(const auto generic = convert::generic_func_table[from][to]; generic != func) {
+                    std::vector<u8> expected(dst.size());
+                    generic(src.data(), expected.data(), n_samples);
+                    func(src.data(), dst.data(), n_samples);
+                    if(expected != dst) {
+                        std::printf("FAIL: %s -> %s differs from the generic converter\n", src_info.name, dst_info.name);
+                        failures += 1;
+                    }
+                }
+            }
+
+            if(src_info.is_float && !dst_info.is_float && !check_saturation(from, to, func)) {
+                failures += 1;
+            }
+
+            // from -> to -> from must be bit-exact if to can hold every value of from
+            const auto back = convert::convert_func_table[to][from];
+            if(back == nullptr || precision(dst_info) < precision(src_info) || (src_info.is_float && !dst_info.is_float)) continue;
+            const size_t    n_samples = boxten::PCMPACKET_PERIOD * 2;
+            auto            src       = make_input(from, n_samples, engine);
+            std::vector<u8> middle(n_samples * dst_info.width);
+            std::vector<u8> restored(src.size());
+            func(src.data(), middle.data(), n_samples);
+            back(middle.data(), restored.data(), n_samples);
+            if(restored != src) {
+                std::printf("FAIL: %s -> %s -> %s is not lossless\n", src_info.name, dst_info.name, src_info.name);
+                failures += 1;
+            }
+        }
+    }
+    if(failures != 0) {
+        std::printf("%zu verification(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("all verifications passed\n");
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include <cmath>
+
+#include "channel-matrix.hpp"
+
+namespace channel {
+namespace {
+enum Position : size_t {
+    FL,
+    FR,
+    FC,
+    LFE,
+    BL,
+    BR,
+    SL,
+    SR,
+};
+} // namespace
+
+std::optional<Matrix> route_matrix(size_t in_channels, const std::vector<i64>& map) {
+    if(in_channels == 0 || in_channels > max_channels || map.empty() || map.size() > max_channels) return std::nullopt;
+    Matrix matrix;
+    matrix.in_channels  = in_channels;
+    matrix.out_channels = map.size();
+    matrix.is_route     = true;
+    for(size_t o = 0; o < map.size(); ++o) {
+        if(map[o] >= static_cast<i64>(in_channels)) return std::nullopt;
+        matrix.route[o] = map[o] < 0 ? -1 : static_cast<i32>(map[o]);
+    }
+    return matrix;
+}
+
+std::optional<Matrix> standard_matrix(size_t in_channels, size_t out_channels) {
+    if(in_channels == 1 && out_channels == 2) {
+        return route_matrix(1, {0, 0});
+    }
+
+    Matrix matrix;
+    matrix.in_channels  = in_channels;
+    matrix.out_channels = out_channels;
+    auto& c             = matrix.coefficients;
+    if(in_channels == 2 && out_channels == 1) {
+        c[0][FL] = 0.5f;
+        c[0][FR] = 0.5f;
+        return matrix;
+    }
+    if(out_channels != 2 || (in_channels != 6 && in_channels != 8)) return std::nullopt;
+
+    // itu-r bs.775 downmix without lfe, scaled so that a full scale input can not clip
+    const f32 center = std::sqrt(0.5f);
+    c[0][FL]         = 1.0f;
+    c[1][FR]         = 1.0f;
+    c[0][FC]         = center;
+    c[1][FC]         = center;
+    c[0][BL]         = center;
+    c[1][BR]         = center;
+    f32 sum          = 1.0f + center * 2;
+    if(in_channels == 8) {
+        c[0][SL] = center;
+        c[1][SR] = center;
+        sum += center;
+    }
+    for(auto& row : c) {
+        for(auto& v : row) {
+            v /= sum;
+        }
+    }
+    return matrix;
+}
+} // namespace channel
@@ -0,0 +1,32 @@
+#pragma once
+#include <array>
+#include <optional>
+#include <vector>
+
+#include "type.hpp"
+
+// channel layout changes applied while converting the sample type.
+// channel orders follow wav and flac: FL FR FC LFE BL BR SL SR.
+// alsa devices take 5.1 and 7.1 as FL FR RL RR FC LFE SL SR instead, route_matrix() with
+// {0, 1, 4, 5, 2, 3, 6, 7} (the first 6 for 5.1) reorders for them.
+namespace channel {
+constexpr size_t max_channels = 8;
+
+struct Matrix {
+    size_t in_channels  = 0;
+    size_t out_channels = 0;
+
+    // output channel o is a bit-exact copy of input channel route[o], or silence if it is negative
+    bool                          is_route = false;
+    std::array<i32, max_channels> route    = {};
+
+    // otherwise output channel o is the sum of coefficients[o][i] * input channel i
+    std::array<std::array<f32, max_channels>, max_channels> coefficients = {};
+};
+
+// picks input channels by index. -1 in map means silence.
+std::optional<Matrix> route_matrix(size_t in_channels, const std::vector<i64>& map);
+
+// mono -> stereo, stereo -> mono and 5.1/7.1 -> stereo.
+std::optional<Matrix> standard_matrix(size_t in_channels, size_t out_channels);
+} // namespace channel
@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
+#include "convert.hpp"
+#include "sample.hpp"
+#include "simd.hpp"
+
+namespace convert {
+namespace {
+struct Unknown {};
+
+// must be in the same order as boxten::SampleType
+using SampleTypes = std::tuple<
+    Unknown,
+    sample::F32LE,
+    sample::F32BE,
+    sample::S8,
+    sample::U8,
+    sample::S16LE,
+    sample::S16BE,
+    sample::U16LE,
+    sample::U16BE,
+    sample::S24LE,
+    sample::S24BE,
+    sample::U24LE,
+    sample::U24BE,
+    sample::S32LE,
+    sample::S32BE,
+    sample::U32LE,
+    sample::U32BE>;
+static_assert(std::tuple_size_v<SampleTypes> == n_sample_types);
+
+struct Generic {
+    using Func                          = ConvertFunc;
+    static constexpr bool same_type_too = false;
+
+    template <typename Src, typename Dst>
+    static constexpr ConvertFunc generate() {
+        return sample::convert<Src, Dst>;
+    }
+};
+struct Dither {
+    using Func                          = ConvertFunc;
+    static constexpr bool same_type_too = false;
+
+    template <typename Src, typename Dst>
+    static constexpr ConvertFunc generate() {
+        if constexpr(!Src::is_float && !Dst::is_float) {
+            if constexpr(Src::value_bits == 32 && Dst::bits < Src::bits) {
+                return sample::convert_dither<Src, Dst>;
+            }
+        }
+        return nullptr;
+    }
+};
+
+struct Matrix {
+    using Func                          = MatrixFunc;
+    static constexpr bool same_type_too = true;
+
+    template <typename Src, typename Dst>
+    static constexpr MatrixFunc generate() {
+        return sample::convert_matrix<Src, Dst>;
+    }
+};
+
+template <typename Kind, size_t from, size_t to>
+constexpr typename Kind::Func generate_func() {
+    using Src = std::tuple_element_t<from, SampleTypes>;
+    using Dst = std::tuple_element_t<to, SampleTypes>;
+    if constexpr((from == to && !Kind::same_type_too) || std::is_same_v<Src, Unknown> || std::is_same_v<Dst, Unknown>) {
+        return nullptr;
+    } else {
+        return Kind::template generate<Src, Dst>();
+    }
+}
+template <typename Kind, size_t from, size_t... to>
+constexpr std::array<typename Kind::Func, n_sample_types> generate_row(std::index_sequence<to...>) {
+    return {generate_func<Kind, from, to>()...};
+}
+template <typename Kind, size_t... from>
+constexpr Table<typename Kind::Func> generate_table(std::index_sequence<from...>) {
+    return {generate_row<Kind, from>(std::make_index_sequence<n_sample_types>())...};
+}
+
+template <size_t... index>
+constexpr std::array<SampleInfo, n_sample_types> generate_info(std::index_sequence<index...>) {
+    constexpr const char* names[] = {"unknown", "f32le", "f32be", "s8", "u8", "s16le", "s16be", "u16le", "u16be", "s24le", "s24be", "u24le", "u24be", "s32le", "s32be", "u32le", "u32be"};
+    static_assert(sizeof(names) / sizeof(names[0]) == n_sample_types);
+
+    const auto info = []<size_t i>(const char* name) -> SampleInfo {
+        using Type = std::tuple_element_t<i, SampleTypes>;
+        if constexpr(std::is_same_v<Type, Unknown>) {
+            return {name, 0, 0, false};
+        } else if constexpr(Type::is_float) {
+            return {name, Type::width, Type::bits, true};
+        } else {
+            return {name, Type::width, Type::bits, false};
+        }
+    };
+    return {info.template operator()<index>(names[index])...};
+}
+
+const char* simd_instruction_set = "scalar";
+
+ConvertTable install_simd_kernels(ConvertTable table) {
+    simd_instruction_set = simd::install_kernels(table);
+    return table;
+}
+} // namespace
+
+const std::array<SampleInfo, n_sample_types> sample_info_table = generate_info(std::make_index_sequence<n_sample_types>());
+
+const ConvertTable generic_func_table = generate_table<Generic>(std::make_index_sequence<n_sample_types>());
+const ConvertTable convert_func_table = install_simd_kernels(generic_func_table);
+const ConvertTable dither_func_table  = generate_table<Dither>(std::make_index_sequence<n_sample_types>());
+const MatrixTable  matrix_func_table  = generate_table<Matrix>(std::make_index_sequence<n_sample_types>());
+
+boxten::SampleType find_cheapest_target(boxten::SampleType from, const std::vector<boxten::SampleType>& candidates) {
+    if(std::find(candidates.begin(), candidates.end(), from) != candidates.end()) return from;
+
+    const auto from_index = static_cast<size_t>(from);
+    if(from_index >= n_sample_types) return boxten::SampleType::unknown;
+
+    // f32 holds 24 bits of an integer sample exactly
+    const auto precision = [](const SampleInfo& info) -> size_t {
+        return info.is_float ? 24 : info.bits;
+    };
+    const auto from_precision = precision(sample_info_table[from_index]);
+
+    auto best      = boxten::SampleType::unknown;
+    auto best_cost = std::tuple<size_t, bool, size_t>();
+    for(const auto candidate : candidates) {
+        const auto index = static_cast<size_t>(candidate);
+        if(index >= n_sample_types || convert_func_table[from_index][index] == nullptr) continue;
+        const auto& info      = sample_info_table[index];
+        const auto  lost_bits = from_precision > precision(info) ? from_precision - precision(info) : 0;
+        const auto  no_simd   = convert_func_table[from_index][index] == generic_func_table[from_index][index];
+        const auto  cost      = std::tuple(lost_bits, no_simd, info.width);
+        if(best == boxten::SampleType::unknown || cost < best_cost) {
+            best      = candidate;
+            best_cost = cost;
+        }
+    }
+    return best;
+}
+
+const char* get_simd_instruction_set() {
+    return simd_instruction_set;
+}
+} // namespace convert
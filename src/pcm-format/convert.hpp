@@ -0,0 +1,71 @@
+#pragma once
+#include <array>
+#include <vector>
+
+#include <libboxten.hpp>
+
+#include "channel-matrix.hpp"
+#include "type.hpp"
+
+namespace convert {
+// converts n_samples samples from src to dst.
+// src and dst must not overlap.
+using ConvertFunc = void (*)(u8* src, u8* dst, size_t n_samples);
+
+// converts n_frames frames from src to dst and applies matrix to the channels.
+// src and dst must not overlap.
+using MatrixFunc = void (*)(u8* src, u8* dst, size_t n_frames, const channel::Matrix& matrix);
+
+constexpr size_t n_sample_types = static_cast<size_t>(boxten::SampleType::u32_be) + 1;
+
+template <typename Func>
+using Table        = std::array<std::array<Func, n_sample_types>, n_sample_types>;
+using ConvertTable = Table<ConvertFunc>;
+using MatrixTable  = Table<MatrixFunc>;
+
+struct SampleInfo {
+    const char* name;
+    size_t      width; // bytes per sample
+    size_t      bits;  // significant bits
+    bool        is_float;
+};
+// indexed by boxten::SampleType
+extern const std::array<SampleInfo, n_sample_types> sample_info_table;
+
+// the compile-time generated converters only, without simd kernels.
+// kept for verification of the simd kernels.
+extern const ConvertTable generic_func_table;
+
+// indexed by [from][to]. nullptr means no conversion is needed or possible.
+// generated at compile time, then the simd kernels for the running cpu are installed over it.
+extern const ConvertTable convert_func_table;
+
+// the most advanced instruction set used by convert_func_table
+const char* get_simd_instruction_set();
+
+// same layout as convert_func_table. only narrowing integer pairs have an entry,
+// which adds tpdf dither before dropping the low bits.
+extern const ConvertTable dither_func_table;
+
+// same layout as convert_func_table, but every pair has an entry, including from == to.
+extern const MatrixTable matrix_func_table;
+
+inline ConvertFunc find_converter(boxten::SampleType from, boxten::SampleType to, bool dither = false) {
+    if(static_cast<size_t>(from) >= n_sample_types || static_cast<size_t>(to) >= n_sample_types) return nullptr;
+    if(dither) {
+        if(auto func = dither_func_table[static_cast<size_t>(from)][static_cast<size_t>(to)]; func != nullptr) {
+            return func;
+        }
+    }
+    return convert_func_table[static_cast<size_t>(from)][static_cast<size_t>(to)];
+}
+// picks the target from candidates that is cheapest to convert from into.
+// targets which keep every bit of from come first, then targets with a simd kernel, then narrower ones.
+// returns from itself if it is a candidate and unknown if there is no candidate.
+boxten::SampleType find_cheapest_target(boxten::SampleType from, const std::vector<boxten::SampleType>& candidates);
+
+inline MatrixFunc find_matrix_converter(boxten::SampleType from, boxten::SampleType to) {
+    if(static_cast<size_t>(from) >= n_sample_types || static_cast<size_t>(to) >= n_sample_types) return nullptr;
+    return matrix_func_table[static_cast<size_t>(from)][static_cast<size_t>(to)];
+}
+} // namespace convert
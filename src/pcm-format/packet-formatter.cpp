@@ -0,0 +1,179 @@
+#include <algorithm>
+
+#include "packet-formatter.hpp"
+#include "convert.hpp"
+#include "format-negotiation.hpp"
+
+const channel::Matrix* PacketFormatter::find_matrix(u32 in_channels) {
+    const auto out_channels = options.channels != 0 ? options.channels : negotiate_channels(in_channels);
+    if(options.channel_map.empty() && out_channels == in_channels) return nullptr;
+    if(in_channels != matrix_in_channels || out_channels != matrix_out_channels) {
+        matrix_in_channels  = in_channels;
+        matrix_out_channels = out_channels;
+        matrix              = options.channel_map.empty() ? channel::standard_matrix(in_channels, out_channels) : channel::route_matrix(in_channels, options.channel_map);
+        if(!matrix) {
+            on_error("packet format: no channel matrix for " + std::to_string(in_channels) + " input channels.");
+        }
+    }
+    return matrix ? &*matrix : nullptr;
+}
+
+u32 PacketFormatter::negotiate_channels(u32 from) {
+    const auto generation = negotiation::get_generation();
+    if(generation == negotiated_channels_generation && from == negotiated_channels_from) return negotiated_channels_to;
+
+    negotiated_channels_generation = generation;
+    negotiated_channels_from       = from;
+    negotiated_channels_to         = from;
+    if(const auto formats = negotiation::get_device_formats(); formats && !formats->accepts_channels(from)) {
+        // the first accepted count there is a standard matrix for
+        for(const auto count : formats->channel_counts) {
+            if(channel::standard_matrix(from, count)) {
+                negotiated_channels_to = count;
+                return negotiated_channels_to;
+            }
+        }
+        on_error("packet format: the output device accepts no channel count reachable from " + std::to_string(from) + " channels.");
+    }
+    return negotiated_channels_to;
+}
+boxten::SampleType PacketFormatter::negotiate_target(boxten::SampleType from) {
+    const auto generation = negotiation::get_generation();
+    if(generation == negotiated_generation && from == negotiated_from) return negotiated_to;
+
+    negotiated_generation = generation;
+    negotiated_from       = from;
+    negotiated_to         = from;
+    if(const auto formats = negotiation::get_device_formats(); formats) {
+        if(const auto target = convert::find_cheapest_target(from, formats->sample_types); target != boxten::SampleType::unknown) {
+            negotiated_to = target;
+        } else {
+            on_error("packet format: the output device accepts no sample type reachable from sample type " + std::to_string(static_cast<int>(from)) + ".");
+        }
+    }
+    return negotiated_to;
+}
+
+std::vector<u8> PacketFormatter::take_buffer(size_t bytes, u64& allocations) {
+    const auto by_capacity = [](const std::vector<u8>& a, const std::vector<u8>& b) {
+        return a.capacity() < b.capacity();
+    };
+    // the smallest spare that fits, or else the largest one to grow
+    auto best = spare_buffers.end();
+    for(auto i = spare_buffers.begin(); i != spare_buffers.end(); ++i) {
+        if(i->capacity() >= bytes && (best == spare_buffers.end() || by_capacity(*i, *best))) {
+            best = i;
+        }
+    }
+    if(best == spare_buffers.end()) {
+        best = std::max_element(spare_buffers.begin(), spare_buffers.end(), by_capacity);
+    }
+    std::vector<u8> buffer;
+    if(best != spare_buffers.end()) {
+        std::swap(*best, spare_buffers.back());
+        buffer = std::move(spare_buffers.back());
+        spare_buffers.pop_back();
+    }
+    if(buffer.capacity() < bytes) {
+        allocations += 1;
+    }
+    buffer.resize(bytes);
+    return buffer;
+}
+void PacketFormatter::give_buffer(std::vector<u8>&& buffer) {
+    if(spare_buffers.size() < max_spare_buffers) {
+        spare_buffers.emplace_back(std::move(buffer));
+        return;
+    }
+    // keep the larger buffers, they fit more conversions
+    const auto smallest = std::min_element(spare_buffers.begin(), spare_buffers.end(), [](const std::vector<u8>& a, const std::vector<u8>& b) {
+        return a.capacity() < b.capacity();
+    });
+    if(smallest->capacity() < buffer.capacity()) {
+        *smallest = std::move(buffer);
+    }
+}
+
+bool PacketFormatter::modify_packet(boxten::PCMPacketUnit& packet) {
+    // a native source type is passed through untouched
+    auto dst_format        = packet.format;
+    dst_format.sample_type = options.to != boxten::SampleType::unknown ? options.to : negotiate_target(packet.format.sample_type);
+
+    // the channel matrix and the sample type conversion are done in one pass
+    const auto*          matrix      = find_matrix(packet.format.channels);
+    convert::ConvertFunc func        = nullptr;
+    convert::MatrixFunc  matrix_func = nullptr;
+    if(matrix != nullptr) {
+        // mixing goes through f32, so dither does not apply here
+        matrix_func         = convert::find_matrix_converter(packet.format.sample_type, dst_format.sample_type);
+        dst_format.channels = matrix->out_channels;
+        if(matrix_func == nullptr) return true;
+    } else {
+        func = convert::find_converter(packet.format.sample_type, dst_format.sample_type, options.dither);
+        if(func == nullptr) return true;
+    }
+
+    const size_t n_frames  = packet.get_frames();
+    const size_t n_samples = n_frames * packet.format.channels;
+    const size_t dst_bytes = n_frames * dst_format.channels * dst_format.get_sample_bytewidth();
+
+    struct Context {
+        convert::ConvertFunc   func;
+        convert::MatrixFunc    matrix_func;
+        const channel::Matrix* matrix;
+        u8*                    src;
+        u8*                    dst;
+        size_t                 src_channels;
+        size_t                 src_frame_bytes;
+        size_t                 dst_frame_bytes;
+    };
+    constexpr auto job = [](void* ptr, size_t begin, size_t end) {
+        auto& c   = *reinterpret_cast<Context*>(ptr);
+        auto  src = &c.src[begin * c.src_frame_bytes];
+        auto  dst = &c.dst[begin * c.dst_frame_bytes];
+        if(c.matrix_func != nullptr) {
+            c.matrix_func(src, dst, end - begin, *c.matrix);
+        } else {
+            c.func(src, dst, (end - begin) * c.src_channels);
+        }
+    };
+
+    // convert into a spare buffer and hand it over to the packet, the source buffer becomes a spare.
+    // a buffer only returns to the pool as a source, so a widening conversion allocates whenever
+    // no spare is as large as its output, the counters tell how often that happens.
+    u64     allocations = 0;
+    auto    converted   = take_buffer(dst_bytes, allocations);
+    Context context     = {func, matrix_func, matrix, packet.pcm.data(), converted.data(), packet.format.channels,
+                           packet.format.channels * packet.format.get_sample_bytewidth(), dst_format.channels * dst_format.get_sample_bytewidth()};
+    if(pool && n_samples >= options.parallel_threshold) {
+        // keep every chunk a multiple of the widest simd block
+        pool->run(job, &context, n_frames, 64);
+    } else {
+        job(&context, 0, n_frames);
+    }
+    std::swap(packet.pcm, converted);
+    give_buffer(std::move(converted));
+    packet.format = dst_format;
+
+    stats.packets += 1;
+    stats.allocations += allocations;
+    stats.last_packet_allocations = allocations;
+    return true;
+}
+PacketFormatter::Stats PacketFormatter::get_stats() const {
+    return stats;
+}
+const PacketFormatter::Options& PacketFormatter::get_options() const {
+    return options;
+}
+PacketFormatter::PacketFormatter(Options options, ErrorHandler on_error) : options(std::move(options)), on_error(std::move(on_error)) {
+    if(this->options.worker_threads > 0) {
+        pool.reset(new WorkerPool(this->options.worker_threads));
+    }
+    // no allocation when a buffer changes hands
+    spare_buffers.reserve(max_spare_buffers);
+    spare_buffers.resize(2);
+    for(auto& buffer : spare_buffers) {
+        buffer.reserve(boxten::PCMPACKET_PERIOD * 2 * sizeof(f32));
+    }
+}
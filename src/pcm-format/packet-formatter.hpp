@@ -0,0 +1,79 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "channel-matrix.hpp"
+#include "worker-pool.hpp"
+#include <libboxten.hpp>
+
+// the packet processing of the packet format module, without the module configuration around it,
+// so that the replay driver runs exactly what the module runs.
+class PacketFormatter {
+  public:
+    struct Options {
+        boxten::SampleType to     = boxten::SampleType::unknown; // unknown negotiates with the output
+        bool               dither = false;
+
+        // output channel count (0 keeps the input layout unless the output device refuses it)
+        // or an explicit channel map, which the alsa output needs for more than 2 channels,
+        // see channel-matrix.hpp.
+        u32              channels = 0;
+        std::vector<i64> channel_map;
+
+        // packets with at least parallel_threshold samples are split across worker_threads threads
+        size_t worker_threads     = 0;
+        size_t parallel_threshold = boxten::PCMPACKET_PERIOD * 32;
+    };
+    struct Stats {
+        u64 packets                 = 0;
+        u64 allocations             = 0; // heap allocations done by the conversion
+        u64 last_packet_allocations = 0;
+    };
+    static constexpr size_t max_spare_buffers = 4;
+    using ErrorHandler = std::function<void(const std::string& message)>;
+
+  private:
+    Options         options;
+    ErrorHandler    on_error;
+    Stats           stats;
+
+    // buffers to convert into. a converted packet takes one and leaves its source buffer
+    // in exchange, so the pool holds on to the largest buffers it was given.
+    std::vector<std::vector<u8>> spare_buffers;
+
+    std::vector<u8> take_buffer(size_t bytes, u64& allocations);
+    void            give_buffer(std::vector<u8>&& buffer);
+
+    // the matrix is rebuilt when the input or output channel count changes.
+    u32                            matrix_in_channels  = 0;
+    u32                            matrix_out_channels = 0;
+    std::optional<channel::Matrix> matrix;
+
+    const channel::Matrix* find_matrix(u32 in_channels);
+
+    // the output channel count when "channels" is not set, cached like the sample type below.
+    u64 negotiated_channels_generation = 0;
+    u32 negotiated_channels_from       = 0;
+    u32 negotiated_channels_to         = 0;
+
+    u32 negotiate_channels(u32 from);
+
+    // the target sample type when "to" is not set, chosen from what the output device accepts.
+    // cached until the device formats change.
+    u64                negotiated_generation = 0;
+    boxten::SampleType negotiated_from       = boxten::SampleType::unknown;
+    boxten::SampleType negotiated_to         = boxten::SampleType::unknown;
+
+    boxten::SampleType negotiate_target(boxten::SampleType from);
+
+    std::unique_ptr<WorkerPool> pool;
+
+  public:
+    bool           modify_packet(boxten::PCMPacketUnit& packet);
+    Stats          get_stats() const;
+    const Options& get_options() const;
+    PacketFormatter(Options options, ErrorHandler on_error);
+};
@@ -1,15 +1,22 @@
 #pragma once
+#include <memory>
+
+#include "packet-formatter.hpp"
 #include "plugin.hpp"
 #include <libboxten.hpp>
 
 #include <config.h>
 
 class PCMFormat : public boxten::SoundProcessor {
+  public:
+    using Stats = PacketFormatter::Stats;
+
   private:
-    boxten::SampleType to = boxten::SampleType::unknown;
+    std::unique_ptr<PacketFormatter> formatter;
 
   public:
-    bool modify_packet(boxten::PCMPacketUnit& packet) override;
+    bool  modify_packet(boxten::PCMPacketUnit& packet) override;
+    Stats get_stats() const;
     PCMFormat(void* param);
-    ~PCMFormat(); 
+    ~PCMFormat();
 };
@@ -0,0 +1,243 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "channel-matrix.hpp"
+#include "type.hpp"
+
+// building blocks for the conversion kernels.
+// a sample type decodes itself into a common value and encodes itself back:
+//  - integer samples use a left-justified signed integer, so width changes are shifts.
+//  - floating point samples use themselves, normalized to [-1.0, 1.0].
+namespace sample {
+enum class Endian {
+    little,
+    big,
+};
+
+namespace internal {
+template <size_t bytes>
+using Unsigned = std::conditional_t<bytes == 1, u8,
+                 std::conditional_t<bytes == 2, u16,
+                 std::conditional_t<bytes <= 4, u32, u64>>>;
+
+template <typename T>
+inline T byteswap(T value) {
+    if constexpr(sizeof(T) == 1) {
+        return value;
+    } else if constexpr(sizeof(T) == 2) {
+        return __builtin_bswap16(value);
+    } else if constexpr(sizeof(T) == 4) {
+        return __builtin_bswap32(value);
+    } else {
+        return __builtin_bswap64(value);
+    }
+}
+
+// reads a little endian or big endian unsigned integer of any width
+template <size_t bytes, Endian endian>
+inline Unsigned<bytes> load(const u8* src) {
+    Unsigned<bytes> value = 0;
+    if constexpr(bytes == sizeof(value)) {
+        std::memcpy(&value, src, bytes);
+        if constexpr((endian == Endian::little) != (std::endian::native == std::endian::little)) {
+            value = byteswap(value);
+        }
+    } else {
+        for(size_t b = 0; b < bytes; ++b) {
+            const size_t shift = endian == Endian::little ? b * 8 : (bytes - 1 - b) * 8;
+            value |= static_cast<Unsigned<bytes>>(src[b]) << shift;
+        }
+    }
+    return value;
+}
+template <size_t bytes, Endian endian>
+inline void store(u8* dst, Unsigned<bytes> value) {
+    if constexpr(bytes == sizeof(value)) {
+        if constexpr((endian == Endian::little) != (std::endian::native == std::endian::little)) {
+            value = byteswap(value);
+        }
+        std::memcpy(dst, &value, bytes);
+    } else {
+        for(size_t b = 0; b < bytes; ++b) {
+            const size_t shift = endian == Endian::little ? b * 8 : (bytes - 1 - b) * 8;
+            dst[b]             = value >> shift;
+        }
+    }
+}
+} // namespace internal
+
+template <size_t bytes, bool is_signed, Endian endian>
+struct Integer {
+    static constexpr size_t width    = bytes;
+    static constexpr size_t bits     = bytes * 8;
+    static constexpr bool   is_float = false;
+    using Value                      = std::conditional_t<(bytes > 4), i64, i32>;
+
+    static constexpr bool is_unsigned   = !is_signed;
+    static constexpr bool is_big_endian = endian == Endian::big;
+
+    static constexpr size_t value_bits = sizeof(Value) * 8;
+    static constexpr size_t justify    = value_bits - bits;
+
+    static Value decode(const u8* src) {
+        using U = std::make_unsigned_t<Value>;
+        U value = static_cast<U>(internal::load<bytes, endian>(src)) << justify;
+        if constexpr(!is_signed) {
+            value ^= U(1) << (value_bits - 1);
+        }
+        return static_cast<Value>(value);
+    }
+    static void encode(Value value, u8* dst) {
+        using U = std::make_unsigned_t<Value>;
+        U raw   = static_cast<U>(value);
+        if constexpr(!is_signed) {
+            raw ^= U(1) << (value_bits - 1);
+        }
+        internal::store<bytes, endian>(dst, raw >> justify);
+    }
+};
+
+template <typename T, Endian endian>
+struct Float {
+    static constexpr size_t width    = sizeof(T);
+    static constexpr size_t bits     = sizeof(T) * 8;
+    static constexpr bool   is_float = true;
+    using Value                      = T;
+
+    static Value decode(const u8* src) {
+        return std::bit_cast<T>(internal::load<sizeof(T), endian>(src));
+    }
+    static void encode(Value value, u8* dst) {
+        internal::store<sizeof(T), endian>(dst, std::bit_cast<internal::Unsigned<sizeof(T)>>(value));
+    }
+};
+
+// converts a decoded value of Src into a value Dst can encode.
+//  int   -> int   : shift between the left-justified representations
+//  int   -> float : divide by the full scale of the source width
+//  float -> int   : multiply by the full scale of the destination width and clamp,
+//                   so that int -> float -> int round trips are exact and overshoot saturates.
+//                   nan becomes 0
+template <typename Src, typename Dst>
+inline typename Dst::Value transcode(typename Src::Value value) {
+    using DstValue = typename Dst::Value;
+    if constexpr(!Src::is_float && !Dst::is_float) {
+        if constexpr(Src::value_bits > Dst::value_bits) {
+            return static_cast<DstValue>(value >> (Src::value_bits - Dst::value_bits));
+        } else {
+            return static_cast<DstValue>(value) << (Dst::value_bits - Src::value_bits);
+        }
+    } else if constexpr(!Src::is_float) {
+        constexpr DstValue scale = DstValue(1) / static_cast<DstValue>(u64(1) << (Src::value_bits - 1));
+        return static_cast<DstValue>(value) * scale;
+    } else if constexpr(!Dst::is_float) {
+        using F               = typename Src::Value;
+        constexpr F   scale   = static_cast<F>(u64(1) << (Dst::bits - 1));
+        constexpr i64 max     = static_cast<i64>((u64(1) << (Dst::bits - 1)) - 1);
+        constexpr i64 min     = -max - 1;
+        const F       scaled  = value * scale;
+        const i64     whole   = scaled >= static_cast<F>(max) ? max : scaled <= static_cast<F>(min) ? min : scaled == scaled ? static_cast<i64>(scaled) : 0;
+        return static_cast<DstValue>(static_cast<u64>(whole) << Dst::justify);
+    } else {
+        return static_cast<DstValue>(value);
+    }
+}
+
+// the generic kernel every conversion pair is built from.
+// src and dst must not overlap.
+template <typename Src, typename Dst>
+void convert(u8* __restrict src, u8* __restrict dst, size_t n_samples) {
+    for(size_t i = 0; i < n_samples; ++i) {
+        Dst::encode(transcode<Src, Dst>(Src::decode(&src[i * Src::width])), &dst[i * Dst::width]);
+    }
+}
+
+// triangular probability density function dither for narrowing integer conversions.
+// adds the sum of two independent uniform +-0.5 lsb noises and rounds to the destination width.
+class TPDF {
+  private:
+    u32 state;
+
+  public:
+    // returns uniformly distributed 32-bit noise (xorshift32)
+    i32 next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return static_cast<i32>(state);
+    }
+    TPDF(u32 seed) : state(seed != 0 ? seed : 0x9E3779B9) {}
+};
+
+template <typename Src, typename Dst>
+void convert_dither(u8* __restrict src, u8* __restrict dst, size_t n_samples) {
+    static_assert(!Src::is_float && !Dst::is_float && Src::value_bits == 32 && Dst::bits < Src::bits);
+    constexpr i64    half_lsb = i64(1) << (31 - Dst::bits);
+    thread_local u32 seed     = 0x9E3779B9;
+    TPDF             noise(seed);
+    for(size_t i = 0; i < n_samples; ++i) {
+        const i64 value    = Src::decode(&src[i * Src::width]);
+        const i64 dithered = value + (noise.next() >> Dst::bits) + (noise.next() >> Dst::bits) + half_lsb;
+        const i32 clamped  = static_cast<i32>(dithered < INT32_MIN ? INT32_MIN : dithered > INT32_MAX ? INT32_MAX : dithered);
+        Dst::encode(transcode<Src, Dst>(clamped), &dst[i * Dst::width]);
+    }
+    seed = noise.next();
+}
+
+using F32LE = Float<f32, Endian::little>;
+using F32BE = Float<f32, Endian::big>;
+using S8    = Integer<1, true, Endian::little>;
+using U8    = Integer<1, false, Endian::little>;
+using S16LE = Integer<2, true, Endian::little>;
+using S16BE = Integer<2, true, Endian::big>;
+using U16LE = Integer<2, false, Endian::little>;
+using U16BE = Integer<2, false, Endian::big>;
+using S24LE = Integer<3, true, Endian::little>;
+using S24BE = Integer<3, true, Endian::big>;
+using U24LE = Integer<3, false, Endian::little>;
+using U24BE = Integer<3, false, Endian::big>;
+using S32LE = Integer<4, true, Endian::little>;
+using S32BE = Integer<4, true, Endian::big>;
+using U32LE = Integer<4, false, Endian::little>;
+using U32BE = Integer<4, false, Endian::big>;
+
+// converts the sample type and applies a channel matrix in the same pass.
+// routes are bit-exact, mixes go through f32.
+// src and dst must not overlap.
+template <typename Src, typename Dst>
+void convert_matrix(u8* __restrict src, u8* __restrict dst, size_t n_frames, const channel::Matrix& matrix) {
+    const size_t in_channels  = matrix.in_channels;
+    const size_t out_channels = matrix.out_channels;
+    if(matrix.is_route) {
+        for(size_t f = 0; f < n_frames; ++f) {
+            const u8* in  = &src[f * in_channels * Src::width];
+            u8*       out = &dst[f * out_channels * Dst::width];
+            for(size_t o = 0; o < out_channels; ++o) {
+                const auto route = matrix.route[o];
+                const auto value = route < 0 ? typename Dst::Value(0) : transcode<Src, Dst>(Src::decode(&in[route * Src::width]));
+                Dst::encode(value, &out[o * Dst::width]);
+            }
+        }
+        return;
+    }
+    for(size_t f = 0; f < n_frames; ++f) {
+        const u8* in  = &src[f * in_channels * Src::width];
+        u8*       out = &dst[f * out_channels * Dst::width];
+        f32       values[channel::max_channels];
+        for(size_t i = 0; i < in_channels; ++i) {
+            values[i] = transcode<Src, F32LE>(Src::decode(&in[i * Src::width]));
+        }
+        for(size_t o = 0; o < out_channels; ++o) {
+            const auto& coefficients = matrix.coefficients[o];
+            f32         mixed        = 0;
+            for(size_t i = 0; i < in_channels; ++i) {
+                mixed += coefficients[i] * values[i];
+            }
+            Dst::encode(transcode<F32LE, Dst>(mixed), &out[o * Dst::width]);
+        }
+    }
+}
+} // namespace sample
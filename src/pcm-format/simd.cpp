@@ -0,0 +1,530 @@
+#include "simd.hpp"
+#include "sample.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86
+#include <immintrin.h>
+#define TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace simd {
+namespace {
+#ifdef SIMD_X86
+using namespace sample;
+
+void set(convert::ConvertTable& table, boxten::SampleType from, boxten::SampleType to, convert::ConvertFunc kernel) {
+    table[static_cast<size_t>(from)][static_cast<size_t>(to)] = kernel;
+}
+
+namespace sse2 {
+// reverses the byte order of each width-byte element
+template <size_t width>
+TARGET("sse2") inline __m128i byteswap(__m128i value) {
+    if constexpr(width == 4) {
+        value = _mm_shufflehi_epi16(_mm_shufflelo_epi16(value, 0xB1), 0xB1);
+    }
+    return _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8));
+}
+
+template <typename Src>
+TARGET("sse2") inline __m128 load_float(const u8* src) {
+    const __m128 value = _mm_loadu_ps(reinterpret_cast<const f32*>(src));
+    if constexpr(std::is_same_v<Src, F32BE>) {
+        return _mm_castsi128_ps(byteswap<4>(_mm_castps_si128(value)));
+    } else {
+        return value;
+    }
+}
+
+// scales normalized samples to the full scale of Dst and converts them to i32,
+// saturating on overshoot and turning nan into 0, as transcode does.
+// the result is right-justified. values for 8 and 16-bit types are only
+// valid after being packed with signed saturation.
+template <typename Dst>
+TARGET("sse2") inline __m128i saturate(__m128 value) {
+    const __m128 scale  = _mm_set1_ps(static_cast<f32>(u64(1) << (Dst::bits - 1)));
+    const __m128 scaled = _mm_mul_ps(_mm_and_ps(value, _mm_cmpord_ps(value, value)), scale);
+    if constexpr(Dst::bits == 32) {
+        // cvttps returns 0x80000000 on overflow, flip it to 0x7FFFFFFF on the positive side
+        const __m128i overflow = _mm_castps_si128(_mm_cmpge_ps(scaled, scale));
+        return _mm_xor_si128(_mm_cvttps_epi32(scaled), overflow);
+    } else if constexpr(Dst::bits <= 16) {
+        // negative overflow yields 0x80000000, which packs saturates anyway
+        const __m128 max = _mm_set1_ps(static_cast<f32>((u64(1) << (Dst::bits - 1)) - 1));
+        return _mm_cvttps_epi32(_mm_min_ps(scaled, max));
+    } else {
+        const __m128 max = _mm_set1_ps(static_cast<f32>((u64(1) << (Dst::bits - 1)) - 1));
+        const __m128 min = _mm_set1_ps(-static_cast<f32>(u64(1) << (Dst::bits - 1)));
+        return _mm_cvttps_epi32(_mm_max_ps(_mm_min_ps(scaled, max), min));
+    }
+}
+
+// converts 16 bytes of Dst samples from signed little endian
+template <typename Dst>
+TARGET("sse2") inline __m128i finish(__m128i value) {
+    if constexpr(Dst::is_unsigned) {
+        if constexpr(Dst::width == 1) {
+            value = _mm_xor_si128(value, _mm_set1_epi8(static_cast<char>(0x80)));
+        } else if constexpr(Dst::width == 2) {
+            value = _mm_xor_si128(value, _mm_set1_epi16(static_cast<short>(0x8000)));
+        } else {
+            value = _mm_xor_si128(value, _mm_set1_epi32(INT32_MIN));
+        }
+    }
+    if constexpr(Dst::is_big_endian) {
+        value = byteswap<Dst::width>(value);
+    }
+    return value;
+}
+
+// Src is f32le or f32be, Dst is an 8, 16 or 32-bit integer type
+template <typename Src, typename Dst>
+TARGET("sse2") void from_float(u8* src, u8* dst, size_t n_samples) {
+    constexpr size_t step = 16 / Dst::width;
+    size_t           i    = 0;
+    for(; i + step <= n_samples; i += step) {
+        const u8* s = &src[i * 4];
+        __m128i   packed;
+        if constexpr(Dst::width == 1) {
+            const __m128i lo = _mm_packs_epi32(saturate<Dst>(load_float<Src>(s)), saturate<Dst>(load_float<Src>(s + 16)));
+            const __m128i hi = _mm_packs_epi32(saturate<Dst>(load_float<Src>(s + 32)), saturate<Dst>(load_float<Src>(s + 48)));
+            packed           = _mm_packs_epi16(lo, hi);
+        } else if constexpr(Dst::width == 2) {
+            packed = _mm_packs_epi32(saturate<Dst>(load_float<Src>(s)), saturate<Dst>(load_float<Src>(s + 16)));
+        } else {
+            packed = saturate<Dst>(load_float<Src>(s));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[i * Dst::width]), finish<Dst>(packed));
+    }
+    sample::convert<Src, Dst>(&src[i * 4], &dst[i * Dst::width], n_samples - i);
+}
+
+template <typename Src>
+void install_from_float(convert::ConvertTable& table, boxten::SampleType type) {
+    using enum boxten::SampleType;
+    set(table, type, s8, from_float<Src, S8>);
+    set(table, type, u8, from_float<Src, U8>);
+    set(table, type, s16_le, from_float<Src, S16LE>);
+    set(table, type, s16_be, from_float<Src, S16BE>);
+    set(table, type, u16_le, from_float<Src, U16LE>);
+    set(table, type, u16_be, from_float<Src, U16BE>);
+    set(table, type, s32_le, from_float<Src, S32LE>);
+    set(table, type, s32_be, from_float<Src, S32BE>);
+    set(table, type, u32_le, from_float<Src, U32LE>);
+    set(table, type, u32_be, from_float<Src, U32BE>);
+}
+
+TARGET("sse2") void s16le_to_f32le(u8* src, u8* dst, size_t n_samples) {
+    const __m128 scale = _mm_set1_ps(1.0f / 0x8000);
+    size_t       i     = 0;
+    for(; i + 8 <= n_samples; i += 8) {
+        __m128i s  = _mm_loadu_si128(reinterpret_cast<__m128i*>(&src[i * 2]));
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+        _mm_storeu_ps(reinterpret_cast<f32*>(&dst[i * 4]), _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(reinterpret_cast<f32*>(&dst[i * 4 + 16]), _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+    sample::convert<S16LE, F32LE>(&src[i * 2], &dst[i * 4], n_samples - i);
+}
+TARGET("sse2") void s32le_to_f32le(u8* src, u8* dst, size_t n_samples) {
+    const __m128 scale = _mm_set1_ps(1.0f / 0x80000000);
+    size_t       i     = 0;
+    for(; i + 4 <= n_samples; i += 4) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<__m128i*>(&src[i * 4]));
+        _mm_storeu_ps(reinterpret_cast<f32*>(&dst[i * 4]), _mm_mul_ps(_mm_cvtepi32_ps(s), scale));
+    }
+    sample::convert<S32LE, F32LE>(&src[i * 4], &dst[i * 4], n_samples - i);
+}
+TARGET("sse2") void s16le_to_s32le(u8* src, u8* dst, size_t n_samples) {
+    const __m128i zero = _mm_setzero_si128();
+    size_t        i    = 0;
+    for(; i + 8 <= n_samples; i += 8) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<__m128i*>(&src[i * 2]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[i * 4]), _mm_unpacklo_epi16(zero, s));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[i * 4 + 16]), _mm_unpackhi_epi16(zero, s));
+    }
+    sample::convert<S16LE, S32LE>(&src[i * 2], &dst[i * 4], n_samples - i);
+}
+TARGET("sse2") void s32le_to_s16le(u8* src, u8* dst, size_t n_samples) {
+    size_t i = 0;
+    for(; i + 8 <= n_samples; i += 8) {
+        __m128i lo = _mm_srai_epi32(_mm_loadu_si128(reinterpret_cast<__m128i*>(&src[i * 4])), 16);
+        __m128i hi = _mm_srai_epi32(_mm_loadu_si128(reinterpret_cast<__m128i*>(&src[i * 4 + 16])), 16);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[i * 2]), _mm_packs_epi32(lo, hi));
+    }
+    sample::convert<S32LE, S16LE>(&src[i * 4], &dst[i * 2], n_samples - i);
+}
+TARGET("sse2") void u8_to_s16le(u8* src, u8* dst, size_t n_samples) {
+    const __m128i sign = _mm_set1_epi8(static_cast<char>(0x80));
+    const __m128i zero = _mm_setzero_si128();
+    size_t        i    = 0;
+    for(; i + 16 <= n_samples; i += 16) {
+        __m128i s = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<__m128i*>(&src[i])), sign);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[i * 2]), _mm_unpacklo_epi8(zero, s));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[i * 2 + 16]), _mm_unpackhi_epi8(zero, s));
+    }
+    sample::convert<U8, S16LE>(&src[i], &dst[i * 2], n_samples - i);
+}
+
+void install(convert::ConvertTable& table) {
+    using enum boxten::SampleType;
+    set(table, s16_le, f32_le, s16le_to_f32le);
+    set(table, s32_le, f32_le, s32le_to_f32le);
+    set(table, s16_le, s32_le, s16le_to_s32le);
+    set(table, s32_le, s16_le, s32le_to_s16le);
+    set(table, u8, s16_le, u8_to_s16le);
+    install_from_float<F32LE>(table, f32_le);
+    install_from_float<F32BE>(table, f32_be);
+}
+} // namespace sse2
+
+namespace ssse3 {
+// packed 24-bit samples are moved in blocks of 4 samples (12 bytes) with pshufb.
+// a block is loaded and stored as 16 bytes, so the loops stop while 4 spare bytes remain
+// and leave the rest to the generic converter.
+// unpacked samples are left-justified 32-bit values, which s32le and the
+// int -> float scale of the generic converters share.
+template <typename Type>
+TARGET("ssse3") inline __m128i unpack_mask() {
+    if constexpr(Type::is_big_endian) {
+        return _mm_setr_epi8(-1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9);
+    } else {
+        return _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+    }
+}
+template <typename Type>
+TARGET("ssse3") inline __m128i pack_mask() {
+    if constexpr(Type::is_big_endian) {
+        return _mm_setr_epi8(3, 2, 1, 7, 6, 5, 11, 10, 9, 15, 14, 13, -1, -1, -1, -1);
+    } else {
+        return _mm_setr_epi8(1, 2, 3, 5, 6, 7, 9, 10, 11, 13, 14, 15, -1, -1, -1, -1);
+    }
+}
+template <typename Type>
+TARGET("ssse3") inline __m128i sign_mask() {
+    return _mm_set1_epi32(Type::is_unsigned ? INT32_MIN : 0);
+}
+
+template <typename Src, typename Dst>
+TARGET("ssse3") inline void store_unpacked(u8* dst, __m128i value) {
+    if constexpr(Dst::is_float) {
+        _mm_storeu_ps(reinterpret_cast<f32*>(dst), _mm_mul_ps(_mm_cvtepi32_ps(value), _mm_set1_ps(1.0f / 0x80000000)));
+    } else {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), value);
+    }
+}
+template <typename Src, typename Dst>
+TARGET("ssse3") inline __m128i load_unpacked(const u8* src) {
+    if constexpr(Src::is_float) {
+        return _mm_slli_epi32(sse2::saturate<Dst>(sse2::load_float<Src>(src)), 8);
+    } else {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    }
+}
+
+// Src is a 24-bit type, Dst is s32le or f32le
+template <typename Src, typename Dst>
+TARGET("ssse3") void from_packed24(u8* src, u8* dst, size_t n_samples) {
+    const __m128i mask = unpack_mask<Src>();
+    const __m128i sign = sign_mask<Src>();
+    size_t        i    = 0;
+    for(; i + 10 <= n_samples; i += 8) {
+        __m128i lo = _mm_xor_si128(_mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i*>(&src[i * 3])), mask), sign);
+        __m128i hi = _mm_xor_si128(_mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i*>(&src[i * 3 + 12])), mask), sign);
+        store_unpacked<Src, Dst>(&dst[i * 4], lo);
+        store_unpacked<Src, Dst>(&dst[i * 4 + 16], hi);
+    }
+    sample::convert<Src, Dst>(&src[i * 3], &dst[i * 4], n_samples - i);
+}
+// Src is s32le, f32le or f32be, Dst is a 24-bit type
+template <typename Src, typename Dst>
+TARGET("ssse3") void to_packed24(u8* src, u8* dst, size_t n_samples) {
+    const __m128i mask = pack_mask<Dst>();
+    const __m128i sign = sign_mask<Dst>();
+    size_t        i    = 0;
+    for(; i + 10 <= n_samples; i += 8) {
+        __m128i lo = _mm_shuffle_epi8(_mm_xor_si128(load_unpacked<Src, Dst>(&src[i * 4]), sign), mask);
+        __m128i hi = _mm_shuffle_epi8(_mm_xor_si128(load_unpacked<Src, Dst>(&src[i * 4 + 16]), sign), mask);
+        // the second store overwrites the 4 spare bytes of the first one
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[i * 3]), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[i * 3 + 12]), hi);
+    }
+    sample::convert<Src, Dst>(&src[i * 4], &dst[i * 3], n_samples - i);
+}
+
+TARGET("ssse3") void s24le_to_s16le(u8* src, u8* dst, size_t n_samples) {
+    // keep the upper two bytes of each packed sample
+    const __m128i lo_mask = _mm_setr_epi8(1, 2, 4, 5, 7, 8, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i hi_mask = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, 1, 2, 4, 5, 7, 8, 10, 11);
+    size_t        i       = 0;
+    // the second load reads 4 bytes past the 8th sample
+    for(; i + 10 <= n_samples; i += 8) {
+        __m128i lo = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i*>(&src[i * 3])), lo_mask);
+        __m128i hi = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i*>(&src[i * 3 + 12])), hi_mask);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[i * 2]), _mm_or_si128(lo, hi));
+    }
+    sample::convert<S24LE, S16LE>(&src[i * 3], &dst[i * 2], n_samples - i);
+}
+
+template <typename Type>
+void install_packed24(convert::ConvertTable& table, boxten::SampleType type) {
+    using enum boxten::SampleType;
+    set(table, type, s32_le, from_packed24<Type, S32LE>);
+    set(table, type, f32_le, from_packed24<Type, F32LE>);
+    set(table, s32_le, type, to_packed24<S32LE, Type>);
+    set(table, f32_le, type, to_packed24<F32LE, Type>);
+    set(table, f32_be, type, to_packed24<F32BE, Type>);
+}
+
+void install(convert::ConvertTable& table) {
+    using enum boxten::SampleType;
+    set(table, s24_le, s16_le, s24le_to_s16le);
+    install_packed24<S24LE>(table, s24_le);
+    install_packed24<S24BE>(table, s24_be);
+    install_packed24<U24LE>(table, u24_le);
+    install_packed24<U24BE>(table, u24_be);
+}
+} // namespace ssse3
+
+namespace avx2 {
+// same layout as ssse3, but 8 samples per register and 16 samples per step.
+// each 128-bit lane holds one 12-byte block.
+TARGET("avx2") inline __m256i load_blocks(const u8* src) {
+    const auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    const auto hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 12));
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+}
+TARGET("avx2") inline void store_blocks(u8* dst, __m256i blocks) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm256_castsi256_si128(blocks));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 12), _mm256_extracti128_si256(blocks, 1));
+}
+
+template <size_t width>
+TARGET("avx2") inline __m256i byteswap(__m256i value) {
+    if constexpr(width == 4) {
+        value = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(value, 0xB1), 0xB1);
+    }
+    return _mm256_or_si256(_mm256_slli_epi16(value, 8), _mm256_srli_epi16(value, 8));
+}
+
+template <typename Src>
+TARGET("avx2") inline __m256 load_float(const u8* src) {
+    const __m256 value = _mm256_loadu_ps(reinterpret_cast<const f32*>(src));
+    if constexpr(std::is_same_v<Src, F32BE>) {
+        return _mm256_castsi256_ps(byteswap<4>(_mm256_castps_si256(value)));
+    } else {
+        return value;
+    }
+}
+
+// same as sse2::saturate
+template <typename Dst>
+TARGET("avx2") inline __m256i saturate(__m256 value) {
+    const __m256 scale  = _mm256_set1_ps(static_cast<f32>(u64(1) << (Dst::bits - 1)));
+    const __m256 scaled = _mm256_mul_ps(_mm256_and_ps(value, _mm256_cmp_ps(value, value, _CMP_ORD_Q)), scale);
+    if constexpr(Dst::bits == 32) {
+        const __m256i overflow = _mm256_castps_si256(_mm256_cmp_ps(scaled, scale, _CMP_GE_OQ));
+        return _mm256_xor_si256(_mm256_cvttps_epi32(scaled), overflow);
+    } else if constexpr(Dst::bits <= 16) {
+        const __m256 max = _mm256_set1_ps(static_cast<f32>((u64(1) << (Dst::bits - 1)) - 1));
+        return _mm256_cvttps_epi32(_mm256_min_ps(scaled, max));
+    } else {
+        const __m256 max = _mm256_set1_ps(static_cast<f32>((u64(1) << (Dst::bits - 1)) - 1));
+        const __m256 min = _mm256_set1_ps(-static_cast<f32>(u64(1) << (Dst::bits - 1)));
+        return _mm256_cvttps_epi32(_mm256_max_ps(_mm256_min_ps(scaled, max), min));
+    }
+}
+
+template <typename Dst>
+TARGET("avx2") inline __m256i finish(__m256i value) {
+    if constexpr(Dst::is_unsigned) {
+        if constexpr(Dst::width == 1) {
+            value = _mm256_xor_si256(value, _mm256_set1_epi8(static_cast<char>(0x80)));
+        } else if constexpr(Dst::width == 2) {
+            value = _mm256_xor_si256(value, _mm256_set1_epi16(static_cast<short>(0x8000)));
+        } else {
+            value = _mm256_xor_si256(value, _mm256_set1_epi32(INT32_MIN));
+        }
+    }
+    if constexpr(Dst::is_big_endian) {
+        value = byteswap<Dst::width>(value);
+    }
+    return value;
+}
+
+// packs work per 128-bit lane, so the sample order is restored after packing
+template <typename Src, typename Dst>
+TARGET("avx2") void from_float(u8* src, u8* dst, size_t n_samples) {
+    constexpr size_t step = 32 / Dst::width;
+    size_t           i    = 0;
+    for(; i + step <= n_samples; i += step) {
+        const u8* s = &src[i * 4];
+        __m256i   packed;
+        if constexpr(Dst::width == 1) {
+            const __m256i lo = _mm256_packs_epi32(saturate<Dst>(load_float<Src>(s)), saturate<Dst>(load_float<Src>(s + 32)));
+            const __m256i hi = _mm256_packs_epi32(saturate<Dst>(load_float<Src>(s + 64)), saturate<Dst>(load_float<Src>(s + 96)));
+            packed           = _mm256_permutevar8x32_epi32(_mm256_packs_epi16(lo, hi), _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+        } else if constexpr(Dst::width == 2) {
+            packed = _mm256_packs_epi32(saturate<Dst>(load_float<Src>(s)), saturate<Dst>(load_float<Src>(s + 32)));
+            packed = _mm256_permute4x64_epi64(packed, 0xD8);
+        } else {
+            packed = saturate<Dst>(load_float<Src>(s));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&dst[i * Dst::width]), finish<Dst>(packed));
+    }
+    sse2::from_float<Src, Dst>(&src[i * 4], &dst[i * Dst::width], n_samples - i);
+}
+
+template <typename Src>
+void install_from_float(convert::ConvertTable& table, boxten::SampleType type) {
+    using enum boxten::SampleType;
+    set(table, type, s8, from_float<Src, S8>);
+    set(table, type, u8, from_float<Src, U8>);
+    set(table, type, s16_le, from_float<Src, S16LE>);
+    set(table, type, s16_be, from_float<Src, S16BE>);
+    set(table, type, u16_le, from_float<Src, U16LE>);
+    set(table, type, u16_be, from_float<Src, U16BE>);
+    set(table, type, s32_le, from_float<Src, S32LE>);
+    set(table, type, s32_be, from_float<Src, S32BE>);
+    set(table, type, u32_le, from_float<Src, U32LE>);
+    set(table, type, u32_be, from_float<Src, U32BE>);
+}
+
+template <typename Src, typename Dst>
+TARGET("avx2") inline void store_unpacked(u8* dst, __m256i value) {
+    if constexpr(Dst::is_float) {
+        _mm256_storeu_ps(reinterpret_cast<f32*>(dst), _mm256_mul_ps(_mm256_cvtepi32_ps(value), _mm256_set1_ps(1.0f / 0x80000000)));
+    } else {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), value);
+    }
+}
+template <typename Src, typename Dst>
+TARGET("avx2") inline __m256i load_unpacked(const u8* src) {
+    if constexpr(Src::is_float) {
+        return _mm256_slli_epi32(saturate<Dst>(load_float<Src>(src)), 8);
+    } else {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    }
+}
+
+template <typename Src, typename Dst>
+TARGET("avx2") void from_packed24(u8* src, u8* dst, size_t n_samples) {
+    const __m256i mask = _mm256_broadcastsi128_si256(ssse3::unpack_mask<Src>());
+    const __m256i sign = _mm256_broadcastsi128_si256(ssse3::sign_mask<Src>());
+    size_t        i    = 0;
+    for(; i + 18 <= n_samples; i += 16) {
+        __m256i lo = _mm256_xor_si256(_mm256_shuffle_epi8(load_blocks(&src[i * 3]), mask), sign);
+        __m256i hi = _mm256_xor_si256(_mm256_shuffle_epi8(load_blocks(&src[i * 3 + 24]), mask), sign);
+        store_unpacked<Src, Dst>(&dst[i * 4], lo);
+        store_unpacked<Src, Dst>(&dst[i * 4 + 32], hi);
+    }
+    ssse3::from_packed24<Src, Dst>(&src[i * 3], &dst[i * 4], n_samples - i);
+}
+template <typename Src, typename Dst>
+TARGET("avx2") void to_packed24(u8* src, u8* dst, size_t n_samples) {
+    const __m256i mask = _mm256_broadcastsi128_si256(ssse3::pack_mask<Dst>());
+    const __m256i sign = _mm256_broadcastsi128_si256(ssse3::sign_mask<Dst>());
+    size_t        i    = 0;
+    for(; i + 18 <= n_samples; i += 16) {
+        __m256i lo = _mm256_shuffle_epi8(_mm256_xor_si256(load_unpacked<Src, Dst>(&src[i * 4]), sign), mask);
+        __m256i hi = _mm256_shuffle_epi8(_mm256_xor_si256(load_unpacked<Src, Dst>(&src[i * 4 + 32]), sign), mask);
+        store_blocks(&dst[i * 3], lo);
+        store_blocks(&dst[i * 3 + 24], hi);
+    }
+    ssse3::to_packed24<Src, Dst>(&src[i * 4], &dst[i * 3], n_samples - i);
+}
+
+TARGET("avx2") void s16le_to_f32le(u8* src, u8* dst, size_t n_samples) {
+    const __m256 scale = _mm256_set1_ps(1.0f / 0x8000);
+    size_t       i     = 0;
+    for(; i + 8 <= n_samples; i += 8) {
+        __m256i s = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<__m128i*>(&src[i * 2])));
+        _mm256_storeu_ps(reinterpret_cast<f32*>(&dst[i * 4]), _mm256_mul_ps(_mm256_cvtepi32_ps(s), scale));
+    }
+    sample::convert<S16LE, F32LE>(&src[i * 2], &dst[i * 4], n_samples - i);
+}
+TARGET("avx2") void s32le_to_f32le(u8* src, u8* dst, size_t n_samples) {
+    const __m256 scale = _mm256_set1_ps(1.0f / 0x80000000);
+    size_t       i     = 0;
+    for(; i + 8 <= n_samples; i += 8) {
+        __m256i s = _mm256_loadu_si256(reinterpret_cast<__m256i*>(&src[i * 4]));
+        _mm256_storeu_ps(reinterpret_cast<f32*>(&dst[i * 4]), _mm256_mul_ps(_mm256_cvtepi32_ps(s), scale));
+    }
+    sample::convert<S32LE, F32LE>(&src[i * 4], &dst[i * 4], n_samples - i);
+}
+TARGET("avx2") void s16le_to_s32le(u8* src, u8* dst, size_t n_samples) {
+    size_t i = 0;
+    for(; i + 8 <= n_samples; i += 8) {
+        __m256i s = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<__m128i*>(&src[i * 2])));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&dst[i * 4]), _mm256_slli_epi32(s, 16));
+    }
+    sample::convert<S16LE, S32LE>(&src[i * 2], &dst[i * 4], n_samples - i);
+}
+TARGET("avx2") void s32le_to_s16le(u8* src, u8* dst, size_t n_samples) {
+    size_t i = 0;
+    for(; i + 16 <= n_samples; i += 16) {
+        __m256i lo     = _mm256_srai_epi32(_mm256_loadu_si256(reinterpret_cast<__m256i*>(&src[i * 4])), 16);
+        __m256i hi     = _mm256_srai_epi32(_mm256_loadu_si256(reinterpret_cast<__m256i*>(&src[i * 4 + 32])), 16);
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&dst[i * 2]), packed);
+    }
+    sample::convert<S32LE, S16LE>(&src[i * 4], &dst[i * 2], n_samples - i);
+}
+TARGET("avx2") void u8_to_s16le(u8* src, u8* dst, size_t n_samples) {
+    const __m128i sign = _mm_set1_epi8(static_cast<char>(0x80));
+    size_t        i    = 0;
+    for(; i + 16 <= n_samples; i += 16) {
+        __m128i s = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<__m128i*>(&src[i])), sign);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&dst[i * 2]), _mm256_slli_epi16(_mm256_cvtepi8_epi16(s), 8));
+    }
+    sample::convert<U8, S16LE>(&src[i], &dst[i * 2], n_samples - i);
+}
+
+template <typename Type>
+void install_packed24(convert::ConvertTable& table, boxten::SampleType type) {
+    using enum boxten::SampleType;
+    set(table, type, s32_le, from_packed24<Type, S32LE>);
+    set(table, type, f32_le, from_packed24<Type, F32LE>);
+    set(table, s32_le, type, to_packed24<S32LE, Type>);
+    set(table, f32_le, type, to_packed24<F32LE, Type>);
+    set(table, f32_be, type, to_packed24<F32BE, Type>);
+}
+
+void install(convert::ConvertTable& table) {
+    using enum boxten::SampleType;
+    set(table, s16_le, f32_le, s16le_to_f32le);
+    set(table, s32_le, f32_le, s32le_to_f32le);
+    set(table, s16_le, s32_le, s16le_to_s32le);
+    set(table, s32_le, s16_le, s32le_to_s16le);
+    set(table, u8, s16_le, u8_to_s16le);
+    install_from_float<F32LE>(table, f32_le);
+    install_from_float<F32BE>(table, f32_be);
+    install_packed24<S24LE>(table, s24_le);
+    install_packed24<S24BE>(table, s24_be);
+    install_packed24<U24LE>(table, u24_le);
+    install_packed24<U24BE>(table, u24_be);
+}
+} // namespace avx2
+#endif
+} // namespace
+
+const char* install_kernels(convert::ConvertTable& table) {
+    const char* name = "scalar";
+#ifdef SIMD_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("sse2")) {
+        sse2::install(table);
+        name = "sse2";
+    }
+    if(__builtin_cpu_supports("ssse3")) {
+        ssse3::install(table);
+        name = "ssse3";
+    }
+    if(__builtin_cpu_supports("avx2")) {
+        avx2::install(table);
+        name = "avx2";
+    }
+#endif
+    return name;
+}
+} // namespace simd
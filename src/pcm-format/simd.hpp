@@ -0,0 +1,8 @@
+#pragma once
+#include "convert.hpp"
+
+namespace simd {
+// installs the fastest kernel for each conversion the running cpu supports over table.
+// returns the name of the most advanced instruction set in use.
+const char* install_kernels(convert::ConvertTable& table);
+} // namespace simd
@@ -0,0 +1,65 @@
+#include <algorithm>
+
+#include "worker-pool.hpp"
+
+void WorkerPool::worker_main(size_t index) {
+    u64 done_generation = 0;
+    while(true) {
+        {
+            std::unique_lock<std::mutex> ulock(lock);
+            job_ready.wait(ulock, [&]() { return finish || generation != done_generation; });
+            if(finish) return;
+            done_generation = generation;
+        }
+        run_chunk(index + 1);
+        {
+            std::lock_guard<std::mutex> glock(lock);
+            pending -= 1;
+            if(pending == 0) {
+                job_done.notify_one();
+            }
+        }
+    }
+}
+void WorkerPool::run_chunk(size_t index) {
+    const size_t begin = std::min(index * chunk, n_items);
+    const size_t end   = std::min(begin + chunk, n_items);
+    if(begin != end) {
+        job(context, begin, end);
+    }
+}
+size_t WorkerPool::size() const {
+    return threads.size() + 1;
+}
+void WorkerPool::run(Job job, void* context, size_t n_items, size_t align) {
+    const size_t per_thread = (n_items + size() - 1) / size();
+    {
+        std::lock_guard<std::mutex> glock(lock);
+        this->job     = job;
+        this->context = context;
+        this->n_items = n_items;
+        this->chunk   = (per_thread + align - 1) / align * align;
+        pending       = threads.size();
+        generation += 1;
+    }
+    job_ready.notify_all();
+    run_chunk(0);
+
+    std::unique_lock<std::mutex> ulock(lock);
+    job_done.wait(ulock, [this]() { return pending == 0; });
+}
+WorkerPool::WorkerPool(size_t n_threads) {
+    for(size_t i = 0; i < n_threads; ++i) {
+        threads.emplace_back(&WorkerPool::worker_main, this, i);
+    }
+}
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> glock(lock);
+        finish = true;
+    }
+    job_ready.notify_all();
+    for(auto& t : threads) {
+        t.join();
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "type.hpp"
+
+// persistent threads which split a range of items between them.
+// the calling thread takes a share of the work too.
+class WorkerPool {
+  public:
+    using Job = void (*)(void* context, size_t begin, size_t end);
+
+  private:
+    std::vector<std::thread> threads;
+    std::mutex               lock;
+    std::condition_variable  job_ready;
+    std::condition_variable  job_done;
+    u64                      generation = 0;
+    bool                     finish     = false;
+    size_t                   pending    = 0;
+
+    Job    job;
+    void*  context;
+    size_t n_items;
+    size_t chunk;
+
+    void worker_main(size_t index);
+    void run_chunk(size_t index);
+
+  public:
+    size_t size() const;
+
+    // calls job over [0, n_items) split into chunks which are multiples of align.
+    // returns after all chunks are done.
+    void run(Job job, void* context, size_t n_items, size_t align);
+    WorkerPool(size_t n_threads);
+    ~WorkerPool();
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+};
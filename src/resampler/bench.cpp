@@ -0,0 +1,84 @@
+// speed and accuracy of the resampler.
+// resamples a sine wave between common rates at every quality,
+// reports the speed relative to realtime and the error against an ideal sine.
+// exits with non-zero status if the error exceeds the limit of the quality.
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "filter.hpp"
+#include "kernel.hpp"
+
+namespace {
+struct RatePair {
+    u32 in;
+    u32 out;
+};
+constexpr RatePair rate_pairs[] = {
+    {44100, 48000},
+    {48000, 44100},
+    {44100, 96000},
+    {96000, 44100},
+    {192000, 48000},
+    {44100, 44101}, // more phases than max_phases
+};
+constexpr f64 frequency      = 997;
+constexpr f64 amplitude      = 0.5;
+constexpr f64 max_error_db[] = {-50, -65, -95, -110};
+static_assert(sizeof(max_error_db) / sizeof(max_error_db[0]) == resample::n_qualities);
+
+f64 to_db(f64 value) {
+    return 20 * std::log10(value);
+}
+} // namespace
+
+int main() {
+    constexpr size_t seconds  = 2;
+    const auto       kernel   = resample::get_kernel();
+    size_t           failures = 0;
+
+    std::printf("kernel: %s\n", resample::get_instruction_set());
+    std::printf("%6s -> %6s %-6s %5s %10s %10s\n", "from", "to", "quality", "taps", "realtime", "error dB");
+    for(const auto& pair : rate_pairs) {
+        const size_t     n_src = pair.in * seconds;
+        std::vector<f32> src(n_src);
+        for(size_t i = 0; i < n_src; ++i) {
+            src[i] = amplitude * std::sin(2 * M_PI * frequency * i / pair.in);
+        }
+        for(size_t q = 0; q < resample::n_qualities; ++q) {
+            const auto filter = resample::get_filter(pair.in, pair.out, q);
+
+            // the same warm up the resampler does
+            std::vector<f32> input(filter->center, 0.0f);
+            input.insert(input.end(), src.begin(), src.end());
+            std::vector<f32> dst(n_src * filter->step_up / filter->step_down + 2);
+
+            resample::Position position;
+            const auto         start   = std::chrono::steady_clock::now();
+            const size_t       n_dst   = kernel(*filter, input.data(), input.size(), position, dst.data(), 1);
+            const auto         end     = std::chrono::steady_clock::now();
+            const f64          elapsed = std::chrono::duration<f64>(end - start).count();
+
+            // skip the edges, where the filter sees the silence around the input
+            f64          peak = 0;
+            const size_t skip = filter->taps * pair.out / pair.in + 1;
+            for(size_t i = skip; i + skip < n_dst; ++i) {
+                const f64 expected = amplitude * std::sin(2 * M_PI * frequency * i / pair.out);
+                peak               = std::max(peak, std::abs(dst[i] - expected));
+            }
+            const f64 error = to_db(peak / amplitude);
+            std::printf("%6u -> %6u %-7s %5zu %10.1f %10.1f\n", pair.in, pair.out, resample::qualities[q].name, filter->taps, seconds / elapsed, error);
+            if(error > max_error_db[q]) {
+                std::printf("FAIL: error exceeds %.0f dB\n", max_error_db[q]);
+                failures += 1;
+            }
+        }
+    }
+    if(failures != 0) {
+        std::printf("%zu verification(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("all verifications passed\n");
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <tuple>
+
+#include "filter.hpp"
+
+namespace resample {
+namespace {
+// zeroth order modified bessel function of the first kind
+f64 bessel_i0(f64 x) {
+    f64 sum  = 1;
+    f64 term = 1;
+    for(size_t k = 1; k < 64; ++k) {
+        term *= (x / (2 * k)) * (x / (2 * k));
+        sum += term;
+        if(term < sum * 1e-17) break;
+    }
+    return sum;
+}
+
+f64 sinc(f64 x) {
+    if(x == 0) return 1;
+    return std::sin(M_PI * x) / (M_PI * x);
+}
+
+std::shared_ptr<const Filter> design(u32 in_rate, u32 out_rate, size_t quality) {
+    const auto& q      = qualities[quality];
+    const auto  gcd    = std::gcd(in_rate, out_rate);
+    auto        filter = std::make_shared<Filter>();
+    filter->in_rate    = in_rate;
+    filter->out_rate   = out_rate;
+    filter->quality    = quality;
+    filter->step_up    = out_rate / gcd;
+    filter->step_down  = in_rate / gcd;
+    filter->n_phases   = std::min(filter->step_up, max_phases);
+
+    // when decimating, the cutoff moves down and the filter gets longer by the same factor
+    const f64 ratio  = std::min(1.0, static_cast<f64>(out_rate) / in_rate);
+    const f64 cutoff = ratio * q.rolloff;
+    filter->taps     = (static_cast<size_t>(std::ceil(q.taps / ratio)) + 7) / 8 * 8;
+    filter->center   = filter->taps / 2 - 1;
+
+    const f64        half   = filter->taps / 2.0;
+    const f64        i0beta = bessel_i0(q.beta);
+    std::vector<f64> phase(filter->taps);
+    filter->coefficients.resize((filter->n_phases + 1) * filter->taps);
+    for(size_t p = 0; p <= filter->n_phases; ++p) {
+        const f64 frac   = static_cast<f64>(p) / filter->n_phases;
+        f32*      coeffs = &filter->coefficients[p * filter->taps];
+        f64       sum    = 0;
+        for(size_t j = 0; j < filter->taps; ++j) {
+            const f64 x      = static_cast<f64>(j) - filter->center - frac;
+            const f64 w      = x / half;
+            const f64 window = std::abs(w) >= 1 ? 0 : bessel_i0(q.beta * std::sqrt(1 - w * w)) / i0beta;
+            phase[j]         = cutoff * sinc(cutoff * x) * window;
+            sum += phase[j];
+        }
+        // unity gain at dc for every phase
+        for(size_t j = 0; j < filter->taps; ++j) {
+            coeffs[j] = phase[j] / sum;
+        }
+    }
+    return filter;
+}
+} // namespace
+
+std::shared_ptr<const Filter> get_filter(u32 in_rate, u32 out_rate, size_t quality) {
+    if(in_rate == 0 || out_rate == 0 || quality >= n_qualities) return nullptr;
+
+    static std::mutex                                                          lock;
+    static std::map<std::tuple<u32, u32, size_t>, std::shared_ptr<const Filter>> cache;
+
+    std::lock_guard<std::mutex> glock(lock);
+    auto&                       filter = cache[{in_rate, out_rate, quality}];
+    if(!filter) {
+        filter = design(in_rate, out_rate, quality);
+    }
+    return filter;
+}
+} // namespace resample
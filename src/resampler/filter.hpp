@@ -0,0 +1,54 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+#include "type.hpp"
+
+// polyphase windowed-sinc filters.
+// resampling by out_rate / in_rate is done as upsampling by step_up and decimating by step_down,
+// so each output sample is a dot product of taps input samples and one phase of the filter.
+namespace resample {
+struct Quality {
+    const char* name;
+    size_t      taps;    // per phase when upsampling, multiple of 8
+    f64         beta;    // kaiser window parameter, controls the stopband attenuation
+    f64         rolloff; // passband edge relative to the nyquist frequency of the slower rate
+};
+constexpr Quality qualities[] = {
+    {"fast", 16, 5.0, 0.85},
+    {"medium", 32, 7.0, 0.90},
+    {"high", 64, 9.5, 0.94},
+    {"best", 128, 12.0, 0.96},
+};
+constexpr size_t n_qualities     = sizeof(qualities) / sizeof(qualities[0]);
+constexpr size_t default_quality = 2;
+
+// ratios with more phases than this interpolate between max_phases phases
+constexpr size_t max_phases = 1024;
+
+struct Filter {
+    u32    in_rate;
+    u32    out_rate;
+    size_t quality;
+
+    size_t step_up;   // out_rate / gcd
+    size_t step_down; // in_rate / gcd
+    size_t taps;
+    size_t n_phases;
+
+    // the first output sample lines up with the input sample at this tap
+    size_t center;
+
+    // (n_phases + 1) * taps coefficients, phase major.
+    // the last phase is the first one delayed by a sample, for interpolation.
+    std::vector<f32> coefficients;
+
+    bool is_exact() const {
+        return n_phases == step_up;
+    }
+};
+
+// filters are designed once per rate pair and quality and shared afterwards.
+// returns nullptr if the rates are invalid.
+std::shared_ptr<const Filter> get_filter(u32 in_rate, u32 out_rate, size_t quality);
+} // namespace resample
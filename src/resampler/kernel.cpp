@@ -0,0 +1,124 @@
+#include "kernel.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86
+#include <immintrin.h>
+#define TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace resample {
+namespace {
+// instantiated once per instruction set, so that dot is inlined into the loop
+#define DEFINE_KERNEL(attributes)                                                                                               \
+attributes size_t kernel(const Filter& filter, const f32* src, size_t n_src, Position& position, f32* dst, size_t dst_stride) { \
+    const size_t taps      = filter.taps;                                                                                       \
+    const size_t step_up   = filter.step_up;                                                                                    \
+    const size_t step_int  = filter.step_down / step_up;                                                                        \
+    const size_t step_frac = filter.step_down % step_up;                                                                        \
+    const bool   exact     = filter.is_exact();                                                                                 \
+    const f32*   coeffs    = filter.coefficients.data();                                                                        \
+    size_t       index     = position.index;                                                                                    \
+    size_t       phase     = position.phase;                                                                                    \
+    size_t       n_dst     = 0;                                                                                                 \
+    while(index + taps <= n_src) {                                                                                              \
+        f32 value;                                                                                                              \
+        if(exact) {                                                                                                             \
+            value = dot(&src[index], &coeffs[phase * taps], taps);                                                              \
+        } else {                                                                                                                \
+            const u64    scaled = static_cast<u64>(phase) * filter.n_phases;                                                    \
+            const size_t p      = scaled / step_up;                                                                             \
+            const f32    t      = static_cast<f32>(scaled % step_up) / step_up;                                                 \
+            const f32    a      = dot(&src[index], &coeffs[p * taps], taps);                                                    \
+            const f32    b      = dot(&src[index], &coeffs[(p + 1) * taps], taps);                                              \
+            value               = a + (b - a) * t;                                                                              \
+        }                                                                                                                       \
+        dst[n_dst * dst_stride] = value;                                                                                        \
+        n_dst += 1;                                                                                                             \
+        index += step_int;                                                                                                      \
+        phase += step_frac;                                                                                                     \
+        if(phase >= step_up) {                                                                                                  \
+            phase -= step_up;                                                                                                   \
+            index += 1;                                                                                                         \
+        }                                                                                                                       \
+    }                                                                                                                           \
+    position = {index, phase};                                                                                                  \
+    return n_dst;                                                                                                               \
+}
+
+namespace scalar {
+inline f32 dot(const f32* a, const f32* b, size_t n) {
+    f32 sum = 0;
+    for(size_t i = 0; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+DEFINE_KERNEL()
+} // namespace scalar
+
+#ifdef SIMD_X86
+namespace sse {
+// taps is always a multiple of 8
+TARGET("sse") inline f32 dot(const f32* a, const f32* b, size_t n) {
+    __m128 lo = _mm_setzero_ps();
+    __m128 hi = _mm_setzero_ps();
+    for(size_t i = 0; i < n; i += 8) {
+        lo = _mm_add_ps(lo, _mm_mul_ps(_mm_loadu_ps(&a[i]), _mm_loadu_ps(&b[i])));
+        hi = _mm_add_ps(hi, _mm_mul_ps(_mm_loadu_ps(&a[i + 4]), _mm_loadu_ps(&b[i + 4])));
+    }
+    __m128 sum = _mm_add_ps(lo, hi);
+    sum        = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum        = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+}
+DEFINE_KERNEL(TARGET("sse"))
+} // namespace sse
+
+namespace avx2 {
+TARGET("avx2,fma") inline f32 dot(const f32* a, const f32* b, size_t n) {
+    __m256 lo = _mm256_setzero_ps();
+    __m256 hi = _mm256_setzero_ps();
+    size_t i  = 0;
+    for(; i + 16 <= n; i += 16) {
+        lo = _mm256_fmadd_ps(_mm256_loadu_ps(&a[i]), _mm256_loadu_ps(&b[i]), lo);
+        hi = _mm256_fmadd_ps(_mm256_loadu_ps(&a[i + 8]), _mm256_loadu_ps(&b[i + 8]), hi);
+    }
+    if(i < n) {
+        lo = _mm256_fmadd_ps(_mm256_loadu_ps(&a[i]), _mm256_loadu_ps(&b[i]), lo);
+    }
+    const __m256 sum256 = _mm256_add_ps(lo, hi);
+    __m128       sum    = _mm_add_ps(_mm256_castps256_ps128(sum256), _mm256_extractf128_ps(sum256, 1));
+    sum                 = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum                 = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+}
+DEFINE_KERNEL(TARGET("avx2,fma"))
+} // namespace avx2
+#endif
+
+struct Selected {
+    const char* name;
+    Kernel      kernel;
+};
+Selected select() {
+#ifdef SIMD_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return {"avx2", avx2::kernel};
+    }
+    if(__builtin_cpu_supports("sse")) {
+        return {"sse", sse::kernel};
+    }
+#endif
+    return {"scalar", scalar::kernel};
+}
+const Selected selected = select();
+} // namespace
+
+Kernel get_kernel() {
+    return selected.kernel;
+}
+const char* get_instruction_set() {
+    return selected.name;
+}
+} // namespace resample
@@ -0,0 +1,21 @@
+#pragma once
+#include "filter.hpp"
+
+namespace resample {
+// the input sample of the first tap and the filter phase of the next output sample
+struct Position {
+    size_t index = 0;
+    size_t phase = 0;
+};
+
+// produces output samples of one channel from n_src contiguous input samples,
+// writing every dst_stride floats, until the filter would run past the input.
+// advances position and returns the number of output samples.
+using Kernel = size_t (*)(const Filter& filter, const f32* src, size_t n_src, Position& position, f32* dst, size_t dst_stride);
+
+// the fastest kernel the running cpu supports
+Kernel get_kernel();
+
+// the instruction set get_kernel() uses
+const char* get_instruction_set();
+} // namespace resample
@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <chrono>
+
+#include "packet-resampler.hpp"
+#include "convert.hpp"
+#include "format-negotiation.hpp"
+
+namespace resample {
+u32 PacketResampler::target_rate(u32 in_rate) const {
+    if(options.rate != 0) return options.rate;
+    const auto formats = negotiation::get_device_formats();
+    if(!formats || formats->sampling_rates.empty() || formats->accepts(in_rate)) return in_rate;
+    // the lowest accepted rate above the input, or the highest one
+    u32 above   = 0;
+    u32 highest = 0;
+    for(auto r : formats->sampling_rates) {
+        if(r > in_rate && (above == 0 || r < above)) {
+            above = r;
+        }
+        highest = std::max(highest, r);
+    }
+    return above != 0 ? above : highest;
+}
+bool PacketResampler::modify_packet(boxten::PCMPacketUnit& packet) {
+    const auto out_rate = target_rate(packet.format.sampling_rate);
+    size_t     n_tail   = 0;
+    if(packet.format != current_format || out_rate != current_rate) {
+        // the end of the previous input is still in the filter history, drain it before it is forgotten
+        if(stream.is_ready()) {
+            n_tail = stream.flush(tail);
+            if(out_rate != current_rate || packet.format.channels != current_format.channels) {
+                n_tail = 0;
+            }
+        }
+        current_format = packet.format;
+        current_rate   = out_rate;
+        if(packet.format.sampling_rate != out_rate) {
+            stream.reset(packet.format.sampling_rate, out_rate, options.quality, packet.format.channels);
+        }
+    }
+    const bool resampling = packet.format.sampling_rate != out_rate && stream.is_ready();
+    if(!resampling && n_tail == 0) return true;
+
+    // other sample types go through f32le, the only type the kernels take
+    const auto           type     = packet.format.sample_type;
+    const bool           native   = type == boxten::SampleType::f32_le;
+    convert::ConvertFunc to_f32   = nullptr;
+    convert::ConvertFunc from_f32 = nullptr;
+    if(!native) {
+        to_f32   = convert::find_converter(type, boxten::SampleType::f32_le);
+        from_f32 = convert::find_converter(boxten::SampleType::f32_le, type);
+        if(to_f32 == nullptr || from_f32 == nullptr) {
+            if(!type_reported) {
+                on_error("resampler: sample type " + std::to_string(static_cast<int>(type)) + " cannot be resampled.");
+                type_reported = true;
+            }
+            return true;
+        }
+    }
+
+    const auto   start    = std::chrono::steady_clock::now();
+    const size_t n_frames = packet.get_frames();
+    const size_t channels = packet.format.channels;
+    const size_t width    = packet.format.get_sample_bytewidth();
+    size_t       n_out    = n_frames;
+    if(resampling) {
+        if(native) {
+            n_out = stream.process(reinterpret_cast<const f32*>(packet.pcm.data()), n_frames, scratch);
+            std::swap(packet.pcm, scratch);
+        } else {
+            converted.resize(n_frames * channels * sizeof(f32));
+            to_f32(packet.pcm.data(), converted.data(), n_frames * channels);
+            n_out = stream.process(reinterpret_cast<const f32*>(converted.data()), n_frames, scratch);
+            packet.pcm.resize(n_out * channels * width);
+            from_f32(scratch.data(), packet.pcm.data(), n_out * channels);
+        }
+    }
+    if(n_tail != 0) {
+        // only at format changes, so inserting in front is fine
+        if(!native) {
+            converted.resize(n_tail * channels * width);
+            from_f32(tail.data(), converted.data(), n_tail * channels);
+            std::swap(tail, converted);
+        }
+        packet.pcm.insert(packet.pcm.begin(), tail.begin(), tail.begin() + n_tail * channels * width);
+    }
+    packet.format.sampling_rate = out_rate;
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    stats.packets += 1;
+    stats.input_frames += n_frames;
+    stats.output_frames += n_tail + n_out;
+    stats.nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    return true;
+}
+PacketResampler::Stats PacketResampler::get_stats() const {
+    return stats;
+}
+const PacketResampler::Options& PacketResampler::get_options() const {
+    return options;
+}
+PacketResampler::PacketResampler(Options options, ErrorHandler on_error) : options(options), on_error(std::move(on_error)) {}
+} // namespace resample
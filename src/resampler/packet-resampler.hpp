@@ -0,0 +1,52 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "stream.hpp"
+#include <libboxten.hpp>
+
+namespace resample {
+// the packet processing of the resampler module, without the module configuration around it,
+// so that the replay driver runs exactly what the module runs.
+// converts packets to a fixed sampling rate, or to a rate the output device accepts.
+// packets of other sample types than f32le are resampled through f32le and converted back.
+// when the input format changes, the frames the filter still holds go in front of the next packet
+// if it has the same output rate and channel count.
+class PacketResampler {
+  public:
+    struct Options {
+        u32    rate    = 0; // 0 resamples only rates the output device does not accept
+        size_t quality = default_quality;
+    };
+    struct Stats {
+        u64 packets       = 0;
+        u64 input_frames  = 0;
+        u64 output_frames = 0;
+        u64 nanoseconds   = 0; // time spent in modify_packet
+    };
+    using ErrorHandler = std::function<void(const std::string& message)>;
+
+  private:
+    Options      options;
+    ErrorHandler on_error;
+    Stats        stats;
+
+    // stream of the current input format
+    boxten::PCMFormat current_format;
+    u32               current_rate = 0;
+    Stream            stream;
+    std::vector<u8>   scratch;
+    std::vector<u8>   converted; // f32le copy of non-f32le input
+    std::vector<u8>   tail;      // what the stream of the previous format still held, f32le
+    bool              type_reported = false;
+
+    u32 target_rate(u32 in_rate) const;
+
+  public:
+    bool           modify_packet(boxten::PCMPacketUnit& packet);
+    Stats          get_stats() const;
+    const Options& get_options() const;
+    PacketResampler(Options options, ErrorHandler on_error);
+};
+} // namespace resample
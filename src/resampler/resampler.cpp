@@ -0,0 +1,30 @@
+#include "resampler.hpp"
+#include "configuration.hpp"
+#include "plugin.hpp"
+#include "type.hpp"
+
+bool Resampler::modify_packet(boxten::PCMPacketUnit& packet) {
+    return resampler->modify_packet(packet);
+}
+Resampler::Stats Resampler::get_stats() const {
+    return resampler->get_stats();
+}
+Resampler::Resampler(void* param) : boxten::SoundProcessor(param) {
+    resample::PacketResampler::Options options;
+    if(i64 rate_s; get_number("rate", rate_s) && rate_s >= 0) {
+        options.rate = rate_s;
+    }
+    if(i64 quality_s; get_number("quality", quality_s) && quality_s >= 0 && static_cast<size_t>(quality_s) < resample::n_qualities) {
+        options.quality = quality_s;
+    }
+    resampler.reset(new resample::PacketResampler(options, [this](const std::string& message) {
+        console.error << message << std::endl;
+    }));
+}
+Resampler::~Resampler() {
+    const auto& options = resampler->get_options();
+    set_number("rate", options.rate);
+    set_number("quality", static_cast<i64>(options.quality));
+}
+
+BOXTEN_MODULE({"resampler", boxten::COMPONENT_TYPE::SOUND_PROCESSOR, CATALOGUE_CALLBACK(Resampler)})
@@ -0,0 +1,23 @@
+#pragma once
+#include <memory>
+
+#include "packet-resampler.hpp"
+#include "plugin.hpp"
+#include <libboxten.hpp>
+
+#include <config.h>
+
+// converts packets to a fixed sampling rate, or to a rate the output device accepts.
+class Resampler : public boxten::SoundProcessor {
+  public:
+    using Stats = resample::PacketResampler::Stats;
+
+  private:
+    std::unique_ptr<resample::PacketResampler> resampler;
+
+  public:
+    bool  modify_packet(boxten::PCMPacketUnit& packet) override;
+    Stats get_stats() const;
+    Resampler(void* param);
+    ~Resampler();
+};
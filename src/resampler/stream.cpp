@@ -0,0 +1,66 @@
+#include <algorithm>
+
+#include <libboxten.hpp>
+
+#include "stream.hpp"
+
+namespace resample {
+bool Stream::reset(u32 in_rate, u32 out_rate, size_t quality, size_t channels) {
+    filter   = get_filter(in_rate, out_rate, quality);
+    position      = {};
+    input_frames  = 0;
+    output_frames = 0;
+    history.assign(channels, {});
+    if(!filter) return false;
+    // start with silence before the first sample, so that output and input begin at the same time
+    for(auto& h : history) {
+        h.reserve(filter->taps + boxten::PCMPACKET_PERIOD * 2);
+        h.assign(filter->center, 0.0f);
+    }
+    return true;
+}
+
+size_t Stream::process(const f32* src, size_t n_frames, std::vector<u8>& dst) {
+    const size_t channels = history.size();
+    for(size_t c = 0; c < channels; ++c) {
+        auto&        h    = history[c];
+        const size_t done = h.size();
+        h.resize(done + n_frames);
+        for(size_t f = 0; f < n_frames; ++f) {
+            h[done + f] = src[f * channels + c];
+        }
+    }
+
+    // every channel consumes the same input, so they all end at the same position
+    const size_t n_pending = history[0].size() - position.index;
+    const size_t max_out   = n_pending * filter->step_up / filter->step_down + 2;
+    dst.resize(max_out * channels * sizeof(f32));
+    const auto out   = reinterpret_cast<f32*>(dst.data());
+    size_t     n_out = 0;
+    Position   end;
+    for(size_t c = 0; c < channels; ++c) {
+        end   = position;
+        n_out = kernel(*filter, history[c].data(), history[c].size(), end, &out[c], channels);
+    }
+    for(auto& h : history) {
+        h.erase(h.begin(), h.begin() + end.index);
+    }
+    position = {0, end.phase};
+    dst.resize(n_out * channels * sizeof(f32));
+    input_frames += n_frames;
+    output_frames += n_out;
+    return n_out;
+}
+
+size_t Stream::flush(std::vector<u8>& dst) {
+    // an output frame at input time t reads the taps frames from t on, and one more when the phases are interpolated
+    const size_t           padding = filter->taps - filter->center + 1;
+    const u64              total   = (input_frames * filter->step_up + filter->step_down - 1) / filter->step_down;
+    const u64              owed    = total > output_frames ? total - output_frames : 0;
+    const std::vector<f32> silence(padding * history.size(), 0.0f);
+    const auto             n_out = std::min<u64>(process(silence.data(), padding, dst), owed);
+    dst.resize(n_out * history.size() * sizeof(f32));
+    filter = nullptr;
+    return n_out;
+}
+} // namespace resample
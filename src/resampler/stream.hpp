@@ -0,0 +1,35 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+#include "filter.hpp"
+#include "kernel.hpp"
+
+namespace resample {
+// resamples a continuous stream of interleaved f32 frames delivered in pieces.
+class Stream {
+  private:
+    std::shared_ptr<const Filter> filter;
+    Kernel                        kernel = get_kernel();
+    Position                      position;
+    std::vector<std::vector<f32>> history; // pending input per channel
+    u64                           input_frames  = 0; // since reset()
+    u64                           output_frames = 0;
+
+  public:
+    // forgets the pending input. returns false if there is no filter for the rates.
+    bool reset(u32 in_rate, u32 out_rate, size_t quality, size_t channels);
+
+    // appends n_frames frames and writes every output frame they complete to dst.
+    // dst is resized to the output and its capacity is reused.
+    size_t process(const f32* src, size_t n_frames, std::vector<u8>& dst);
+
+    // ends the input with silence and writes the output frames still owed for the input
+    // given since reset() to dst. the stream is not ready afterwards.
+    size_t flush(std::vector<u8>& dst);
+
+    bool is_ready() const {
+        return filter != nullptr;
+    }
+};
+} // namespace resample